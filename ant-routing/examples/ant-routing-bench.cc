@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+// Microbenchmarks for the hot paths of the anthocnet implementation. The
+// data structures are driven with synthetic neighbors and destinations, no
+// wifi simulation is set up. For every operation the time (ns/op) and the
+// number of heap allocations (allocs/op) are reported.
+//
+// usage: ./waf --run "ant-routing-bench --iterations=100000 --maxSize=10000"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/ant-routing-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+
+using namespace ns3;
+using namespace ns3::ant_routing;
+
+// allocation counting ---------------------------------------------------------
+static uint64_t g_allocations = 0;
+
+void* operator new(std::size_t size) {
+  g_allocations++;
+  if(void* ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+// benchmark driver ------------------------------------------------------------
+template<typename Operation>
+void
+RunBenchmark(std::string name, uint32_t size, uint32_t iterations, Operation operation) {
+  // warm up caches and lazily built structures
+  for(uint32_t i = 0; i < std::min<uint32_t>(iterations, 100); i++) {
+    operation(i);
+  }
+
+  auto allocations = g_allocations;
+  auto start = std::chrono::steady_clock::now();
+  for(uint32_t i = 0; i < iterations; i++) {
+    operation(i);
+  }
+  auto stop = std::chrono::steady_clock::now();
+
+  double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+  std::cout << std::left << std::setw(32) << name
+            << std::right << std::setw(8) << size
+            << std::setw(14) << std::fixed << std::setprecision(1) << ns / iterations
+            << std::setw(14) << std::setprecision(2) << double(g_allocations - allocations) / iterations
+            << std::endl;
+}
+
+// synthetic data --------------------------------------------------------------
+static const uint32_t ENTRIES_PER_DESTINATION = 4;
+
+static Ipv4Address
+NeighborAddress(uint32_t index) {
+  return Ipv4Address(0x0a000000 + index + 1); // 10.0.0.0/16
+}
+
+static Ipv4Address
+DestinationAddress(uint32_t index) {
+  return Ipv4Address(0x0a010000 + index + 1); // 10.1.0.0/16
+}
+
+static uint32_t
+NeighborCountFor(uint32_t size) {
+  return std::min<uint32_t>(size, 32);
+}
+
+// table with size destinations, each having entries for a few neighbors
+static AntRoutingTable
+MakeTable(uint32_t size) {
+  AntRoutingTable table(std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults()));
+  auto neighbors = NeighborCountFor(size);
+  for(uint32_t nb = 0; nb < neighbors; nb++) {
+    table.AddNeighbor(Neighbor(NeighborAddress(nb), AntNetDevice()));
+  }
+
+  for(uint32_t dest = 0; dest < size; dest++) {
+    for(uint32_t j = 0; j < std::min(ENTRIES_PER_DESTINATION, neighbors); j++) {
+      auto nb = (dest + j) % neighbors;
+      table.SetPheromoneAt(NeighborAddress(nb), DestinationAddress(dest),
+                           PheromoneEntry(1.0 / (j + 1), j + 1, MilliSeconds(j + 1)));
+    }
+  }
+  return table;
+}
+
+static void
+NoopForward(Ptr<Ipv4Route> route, Ptr<const Packet> packet, const Ipv4Header& header) { }
+
+// benchmarks ------------------------------------------------------------------
+static void
+BenchRoutingTable(uint32_t size, uint32_t iterations) {
+  auto table = MakeTable(size);
+  auto neighbors = NeighborCountFor(size);
+
+  Ipv4Header header;
+  header.SetSource(Ipv4Address("10.2.0.1"));
+  RunBenchmark("RoutePacket", size, iterations, [&] (uint32_t i) {
+    header.SetDestination(DestinationAddress(i % size));
+    table.RoutePacket(header);
+  });
+
+  RunBenchmark("UpdatePheromoneEntry", size, iterations, [&] (uint32_t i) {
+    table.UpdatePheromoneEntry(NeighborAddress(i % neighbors), DestinationAddress((i * 7) % size),
+                               MilliSeconds(1 + i % 5), 1 + i % 5);
+  });
+
+  RunBenchmark("BestAlternativesFor", size, std::max<uint32_t>(iterations / size, 10), [&] (uint32_t i) {
+    table.BestAlternativesFor(Neighbor(NeighborAddress(i % neighbors), AntNetDevice()));
+  });
+}
+
+static void
+BenchHeaders(uint32_t size, uint32_t iterations) {
+  // the headers encode their lengths in a single byte
+  auto count = std::min<uint32_t>(size, 255);
+
+  std::vector<Ipv4Address> visited;
+  for(uint32_t i = 0; i < count; i++) {
+    visited.push_back(NeighborAddress(i));
+  }
+
+  AntHeader antHeader;
+  antHeader.SetSource(NeighborAddress(0));
+  antHeader.SetDestination(DestinationAddress(0));
+  antHeader.SetVisitedNodes(visited);
+
+  Buffer antBuffer;
+  antBuffer.AddAtStart(antHeader.GetSerializedSize());
+  RunBenchmark("AntHeader::Serialize", count, iterations, [&] (uint32_t) {
+    antHeader.Serialize(antBuffer.Begin());
+  });
+
+  AntHeader antCopy;
+  RunBenchmark("AntHeader::Deserialize", count, iterations, [&] (uint32_t) {
+    antCopy.Deserialize(antBuffer.Begin());
+  });
+
+  std::vector<LinkFailureNotification::Message> messages(count);
+  for(uint32_t i = 0; i < count; i++) {
+    messages[i].dest = DestinationAddress(i);
+    messages[i].bestTimeEstimate = MilliSeconds(i);
+    messages[i].bestHopEstimate = i % 16;
+    messages[i].SetValidEstimates(true);
+  }
+  LinkFailureNotification notification(NeighborAddress(0), visited, messages);
+
+  Buffer failureBuffer;
+  failureBuffer.AddAtStart(notification.GetSerializedSize());
+  RunBenchmark("LinkFailure::Serialize", count, iterations, [&] (uint32_t) {
+    notification.Serialize(failureBuffer.Begin());
+  });
+
+  LinkFailureNotification notificationCopy;
+  RunBenchmark("LinkFailure::Deserialize", count, iterations, [&] (uint32_t) {
+    notificationCopy.Deserialize(failureBuffer.Begin());
+  });
+}
+
+static void
+BenchDevice(uint32_t size, uint32_t iterations) {
+  // the queue never drains without a wifi device, a fresh device is used
+  // every 'size' submissions such that the queue length stays bounded.
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->maxQueueSize = size;
+  auto device = AntNetDevice(Ptr<NetDevice>(), config);
+
+  Ipv4Header header;
+  header.SetDestination(DestinationAddress(0));
+  auto route = Create<Ipv4Route>();
+  auto packet = Create<Packet>(64);
+  auto callback = MakeCallback(&NoopForward);
+
+  RunBenchmark("AntNetDevice::Submit", size, iterations, [&] (uint32_t i) {
+    if(i % size == 0) {
+      device = AntNetDevice(Ptr<NetDevice>(), config);
+    }
+    device.Emplace<UnicastQueueEntry>(route, packet, header, callback);
+  });
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t iterations = 100000;
+  uint32_t maxSize = 10000;
+  bool quiet = true;
+
+  CommandLine cmd;
+  cmd.AddValue ("iterations", "Number of operations per benchmark", iterations);
+  cmd.AddValue ("maxSize", "Largest number of destinations (and visited nodes, messages, queue entries)", maxSize);
+  cmd.AddValue ("quiet", "Discard the unconditional log output of the module", quiet);
+  cmd.Parse (argc, argv);
+
+  // the module logs unconditionally on several of the measured paths
+  auto clogBuffer = std::clog.rdbuf();
+  if(quiet) {
+    std::clog.rdbuf(nullptr);
+  }
+
+  std::cout << std::left << std::setw(32) << "operation"
+            << std::right << std::setw(8) << "size"
+            << std::setw(14) << "ns/op"
+            << std::setw(14) << "allocs/op" << std::endl;
+
+  for(uint32_t size = 10; size <= maxSize; size *= 10) {
+    BenchRoutingTable(size, iterations);
+    BenchHeaders(size, iterations);
+    BenchDevice(size, iterations);
+  }
+
+  std::clog.rdbuf(clogBuffer);
+  Simulator::Destroy ();
+  return 0;
+}
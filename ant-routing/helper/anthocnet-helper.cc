@@ -6,6 +6,7 @@
 #include "ns3/names.h"
 #include "ns3/ptr.h"
 #include "ns3/ipv4-list-routing.h"
+#include <sstream>
 
 namespace ns3 {
 
@@ -22,7 +23,46 @@ namespace ns3 {
 
   Ptr<Ipv4RoutingProtocol> AnthocnetHelper::Create(Ptr<Node> node) const {
     auto router = m_routerFactory.Create<ant_routing::AnthocnetRouting> ();
+    if(m_config) {
+      router -> SetConfig(*m_config);
+    }
     node -> AggregateObject(router);
     return router;
   }
+
+  static std::string SnapshotFileName(std::string prefix, Ptr<Node> node) {
+    std::ostringstream oss;
+    oss << prefix << "-" << node -> GetId() << ".bin";
+    return oss.str();
+  }
+
+  static void SaveSnapshotAll(std::string prefix) {
+    for(uint32_t i = 0; i < NodeList::GetNNodes(); i++) {
+      auto node = NodeList::GetNode(i);
+      auto router = node -> GetObject<ant_routing::AnthocnetRouting>();
+      if(router) {
+        router -> SaveSnapshot(SnapshotFileName(prefix, node));
+      }
+    }
+  }
+
+  void AnthocnetHelper::SaveSnapshotAllAt(Time saveTime, std::string prefix) {
+    Simulator::Schedule(saveTime, &SaveSnapshotAll, prefix);
+  }
+
+  uint32_t AnthocnetHelper::LoadSnapshotAll(std::string prefix) {
+    uint32_t loaded = 0;
+    for(uint32_t i = 0; i < NodeList::GetNNodes(); i++) {
+      auto node = NodeList::GetNode(i);
+      auto router = node -> GetObject<ant_routing::AnthocnetRouting>();
+      if(router && router -> LoadSnapshot(SnapshotFileName(prefix, node))) {
+        loaded++;
+      }
+    }
+    return loaded;
+  }
+
+  void AnthocnetHelper::SetConfig(const ant_routing::AnthocnetConfig& config) {
+    m_config = std::make_shared<ant_routing::AnthocnetConfig>(config);
+  }
 }
@@ -3,6 +3,7 @@
 #define ANTHOCNET_HELPER_H
 
 #include "ns3/ant-routing.h"
+#include "ns3/anthocnet-config.h"
 #include "ns3/ipv4-routing-helper.h"
 #include "ns3/node.h"
 #include "ns3/object-factory.h"
@@ -37,6 +38,25 @@ public:
    */
   virtual Ptr<Ipv4RoutingProtocol> Create(Ptr<Node> node) const override;
 
+  /**
+   * configuration given to every router created by this helper. Without
+   * a configuration the routers use a copy of the defaults.
+   */
+  void SetConfig(const ant_routing::AnthocnetConfig& config);
+
+  /**
+   * saves a snapshot of the routing state of every AntHocNet router at the
+   * given time, to the file "<prefix>-<node id>.bin"
+   */
+  static void SaveSnapshotAllAt(Time saveTime, std::string prefix);
+
+  /**
+   * loads the snapshots saved by SaveSnapshotAllAt into the routers of the
+   * nodes with the same ids. Must be called after the addresses have been
+   * assigned. Returns the number of routers that were warm-started.
+   */
+  static uint32_t LoadSnapshotAll(std::string prefix);
+
 private:
 
   /**
@@ -44,6 +64,11 @@ private:
    */
   ObjectFactory m_routerFactory;
 
+  /**
+   * The configuration for the routers, null if none was set
+   */
+  std::shared_ptr<ant_routing::AnthocnetConfig> m_config;
+
 };
 
 } //namespace ns
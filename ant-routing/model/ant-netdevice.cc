@@ -1,4 +1,13 @@
 #include "ant-netdevice.h"
+#include "ant-packet.h"
+#include "ant-routing.h"
+#include "ns3/timer.h"
+#include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <unordered_map>
 
 namespace ns3 {
   NS_LOG_COMPONENT_DEFINE("AntNetDevice");
@@ -10,27 +19,121 @@ namespace ant_routing {
 struct AntNetDevice::AntNetDeviceImpl {
   // type definitions :
 
-  using SendQueue = std::queue<std::shared_ptr<SendQueueEntry>>;
+  using SendQueue = RingBuffer<SendQueueEntry>;
+
+  // queue of the standard lane holding the entries for a single next hop
+  // (virtual output queue). The queues are served round robin, such that
+  // a next hop which fails doesn't block the traffic to the other ones.
+  struct VirtualQueue {
+    VirtualQueue(Ipv4Address nextHop);
+
+    Ipv4Address m_nextHop;
+    SendQueue m_entries;
+    // the queue isn't served before this time (set after a mac failure)
+    Time m_heldUntil;
+
+    // codel state (RFC 8289)
+    Time m_firstAboveTime; // zero if the sojourn time is below the target
+    Time m_dropNext;
+    uint32_t m_count;
+    uint32_t m_lastCount;
+    bool m_dropping;
+  };
+
+  // scheduling state of a lane (deficit round robin between the lanes)
+  struct LaneState {
+    LaneState();
+
+    uint64_t m_deficit; // bytes the lane may still send in its turn
+    Time m_waitingSince; // time the head of the lane started waiting
+    LaneStatistics m_statistics;
+    SojournHistogram m_sojourn;
+  };
 
   // constructor & destructor
 
-  AntNetDeviceImpl();
-  explicit AntNetDeviceImpl(Ptr<NetDevice> device);
+  AntNetDeviceImpl(Ptr<NetDevice> device, std::shared_ptr<AnthocnetConfig> config);
 
   ~AntNetDeviceImpl();
 
   // methods
 
-  //check if the underlying device is idle (no entries in the queue)
+  //check if the underlying device is idle (no entry handed to the mac)
   bool IsIdle();
 
-  void SubmitTo(std::shared_ptr<SendQueueEntry> entry, SendQueue& queue);
+  // returns the virtual queue for the next hop, creating it if needed
+  VirtualQueue& QueueFor(Ipv4Address nextHop);
+
+  // finds the next virtual queue to be served (round robin), skipping the
+  // held queues. Returns the number of queues if no queue can be served right
+  // now, resumeAt is set to the time the first held queue is released.
+  std::size_t FindVirtualQueue(Time& resumeAt);
+
+  // sojourn time based active queue management (codel) on a virtual queue,
+  // drops the entries at the head of the queue that stayed for too long
+  void CodelDequeue(VirtualQueue& voq);
+  bool CodelOkToDrop(VirtualQueue& voq, Time now);
+  Time CodelControlLaw(Time t, uint32_t count);
+  // drops the entry at the head of the virtual queue
+  void DropFront(VirtualQueue& voq);
+
+  // reads the type of the ant held by the entry, returns false if the entry
+  // holds no ant
+  bool AntTypeOf(SendQueueEntry& entry, AntType& type);
+  // lifetime of an entry submitted to the lane, zero if it never expires
+  Time LifetimeOf(Lane lane, SendQueueEntry& entry);
+  // sets the deadline of a submitted entry
+  void SetDeadline(Lane lane, SendQueueEntry& entry);
+  // drops the entries at the head of the queue whose deadline passed
+  void DropExpired(Lane lane, SendQueue& queue);
+  // drops the expired entries anywhere in the lane, including the held
+  // queues, but keeps the entry in flight
+  void ReapExpired(Lane lane);
+  void ReapExpired(Lane lane, SendQueue& queue);
+
+  // number of entries of the lane waiting to be handed to the mac
+  std::size_t Pending(Lane lane);
+
+  // selects the lane to serve, given the entries at the head of the lanes
+  // (nullptr if the lane has nothing to send) and the size of the frame the
+  // expedited lane would send
+  Lane SelectLane(SendQueueEntry* fast, uint32_t fastSize, SendQueueEntry* standard);
+
+  // deficit round robin between two backlogged lanes
+  Lane SelectByDeficit(uint32_t fastSize, uint32_t standardSize);
 
   // sends the next packet. Note that this operation does not
   // remove an entry from the queue as the entry is used to record the sending
   // time of the packet. The entry is removed only after ack or error
   void SendNext();
 
+  // number of broadcast entries at the front of the fast queue that can share
+  // a single frame, size is set to the size of that frame
+  std::size_t AggregateRun(uint32_t& size);
+  // merges the first count entries of the fast queue into a single
+  // aggregate entry, such that they share a single frame
+  void AggregateBroadcasts(std::size_t count);
+
+  // hands the front entry of the queue to the mac
+  void SendFront(Lane lane, SendQueue& queue, VirtualQueue* voq);
+
+  // removes the entry handed to the mac from its queue
+  void CompleteInFlight();
+
+  // resumes sending once a held queue can be served again
+  void Resume();
+
+  // time the mac is given to report on an entry
+  Time WatchdogBound();
+  // fails the entry handed to the mac if the mac didn't report on it in time
+  void WatchdogExpire();
+  // consumes a report of the mac on an entry the watchdog already failed,
+  // returns false if the report belongs to the entry in flight
+  bool LateReport();
+
+  // capturer for the frames reaching the mac
+  void MacTxCallback(Ptr<const Packet> p);
+
   // caputerer for drops at the mac layer
   void MacTxDropCallback(Ptr<const Packet> p);
 
@@ -43,6 +146,9 @@ struct AntNetDevice::AntNetDeviceImpl {
   // callback to be called when the transmission failed
   void DroppedPacketCallback();
 
+  // fails the entry handed to the mac and continues with the next one
+  void FailInFlight(DropReason reason);
+
   // callback to be called when the transmission was successful
   void DeliveredPacketCallback();
 
@@ -54,29 +160,68 @@ struct AntNetDevice::AntNetDeviceImpl {
   void UnhookTraces(Ptr<NetDevice> device);
 
   // standard lane submission
-  void Submit(std::shared_ptr<SendQueueEntry> entry);
+  void Submit(SendQueueEntry entry);
   // fast lane submission
-  void SubmitExpedited(std::shared_ptr<SendQueueEntry> entry);
+  void SubmitExpedited(SendQueueEntry entry);
+
+  LaneState& StateOf(Lane lane);
+
+  // updates the traced queue lengths
+  void UpdateQueueLengths();
 
   // members:
 
   Ptr<NetDevice> m_device;
-  SendQueue m_stdQueue;
+  std::shared_ptr<AnthocnetConfig> m_config;
   SendQueue m_fastQueue;
+  // note: a deque such that the references to the queues stay valid, the
+  // number of queues is bounded by the number of next hops.
+  std::deque<VirtualQueue> m_stdQueues;
+  std::unordered_map<Ipv4Address, std::size_t, Ipv4AddressHash> m_stdQueueIndex;
+  std::size_t m_nextStdQueue; // round robin position
+  std::size_t m_stdQueueSize; // number of entries in all the virtual queues
+  // the entry handed to the mac sits at the front of this queue (nullptr if idle)
+  SendQueue* m_inFlight;
+  VirtualQueue* m_inFlightVoq; // nullptr if the entry is from the fast lane
+  Timer m_resumeTimer;
+  Timer m_watchdogTimer;
+  // the mac reports only on the frames it got. An entry failed by the
+  // watchdog before reaching the mac (e.g. dropped by the address
+  // resolution) is kept in m_stalledUids, in case it still reaches the mac.
+  // The reports the mac owes on failed entries are ignored until
+  // m_lateReportsUntil.
+  bool m_inFlightAtMac;
+  std::deque<uint64_t> m_stalledUids;
+  uint32_t m_lateReports;
+  Time m_lateReportsUntil;
+  LaneState m_lanes[2];
+  Lane m_turn; // lane having the turn in the deficit round robin
+  // trace sources
+  TracedCallback<Ptr<const Packet>, Lane> m_enqueueTrace;
+  TracedCallback<Ptr<const Packet>, Lane, Time> m_dequeueTrace;
+  TracedCallback<Ptr<const Packet>, Lane, DropReason> m_dropTrace;
+  TracedCallback<Ptr<const Packet>, Lane> m_macTxErrorTrace;
+  TracedValue<uint32_t> m_fastQueueLength;
+  TracedValue<uint32_t> m_stdQueueLength;
   Time m_sendTimeEst; // estimate of the time needed to send a message over the channel
+  Time m_lastTransmission; // time the mac last delivered a frame
   bool m_tracesHooked;
   RouteRepairCallback m_routeRepairCallback;
 };
 
-AntNetDevice::AntNetDeviceImpl::AntNetDeviceImpl()
-  : AntNetDeviceImpl(Ptr<NetDevice>()) { }
-
-
 // note: we call the hookup in the constructor of the AntNetDeviceImpl instead
 // of the constructor of the AntNetDevice since the latter is a reference type
 // and the 'underlying' device must only be hooked up once
-AntNetDevice::AntNetDeviceImpl::AntNetDeviceImpl(Ptr<NetDevice> device)
-  : m_device(device), m_stdQueue(SendQueue()), m_fastQueue(SendQueue()), m_sendTimeEst(MilliSeconds(3)), m_tracesHooked(false) {
+AntNetDevice::AntNetDeviceImpl::AntNetDeviceImpl(Ptr<NetDevice> device, std::shared_ptr<AnthocnetConfig> config)
+  : m_device(device), m_config(config),
+    m_fastQueue(config->maxQueueSize + 1), m_nextStdQueue(0), m_stdQueueSize(0),
+    m_inFlight(nullptr), m_inFlightVoq(nullptr), m_resumeTimer(Timer::CANCEL_ON_DESTROY),
+    m_watchdogTimer(Timer::CANCEL_ON_DESTROY), m_inFlightAtMac(false),
+    m_lateReports(0), m_lateReportsUntil(Seconds(0)),
+    m_turn(Lane::Expedited),
+    m_sendTimeEst(MilliSeconds(3)), m_lastTransmission(Time::Min()), m_tracesHooked(false) {
+    m_resumeTimer.SetFunction(&AntNetDevice::AntNetDeviceImpl::Resume, this);
+    m_watchdogTimer.SetFunction(&AntNetDevice::AntNetDeviceImpl::WatchdogExpire, this);
     HookupTraces(device);
   }
 
@@ -84,48 +229,534 @@ AntNetDevice::AntNetDeviceImpl::~AntNetDeviceImpl() {
   UnhookTraces(m_device);
 }
 
+AntNetDevice::AntNetDeviceImpl::VirtualQueue::VirtualQueue(Ipv4Address nextHop)
+  : m_nextHop(nextHop), m_entries(4), m_heldUntil(Seconds(0)), m_firstAboveTime(Seconds(0)),
+    m_dropNext(Seconds(0)), m_count(0), m_lastCount(0), m_dropping(false) { }
+
+AntNetDevice::AntNetDeviceImpl::LaneState::LaneState()
+  : m_deficit(0), m_waitingSince(Seconds(0)), m_sojourn(MilliSeconds(1), 100) { }
+
+AntNetDevice::AntNetDeviceImpl::LaneState&
+AntNetDevice::AntNetDeviceImpl::StateOf(Lane lane) {
+  return m_lanes[static_cast<std::size_t>(lane)];
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::UpdateQueueLengths() {
+  m_fastQueueLength = m_fastQueue.size();
+  m_stdQueueLength = m_stdQueueSize;
+}
+
 bool
 AntNetDevice::AntNetDeviceImpl::IsIdle() {
-  return m_fastQueue.empty() && m_stdQueue.empty();
+  return m_inFlight == nullptr;
+}
+
+AntNetDevice::AntNetDeviceImpl::VirtualQueue&
+AntNetDevice::AntNetDeviceImpl::QueueFor(Ipv4Address nextHop) {
+  auto it = m_stdQueueIndex.find(nextHop);
+  if(it != m_stdQueueIndex.end()) {
+    return m_stdQueues[it->second];
+  }
+
+  m_stdQueueIndex.emplace(nextHop, m_stdQueues.size());
+  m_stdQueues.emplace_back(nextHop);
+  return m_stdQueues.back();
+}
+
+std::size_t
+AntNetDevice::AntNetDeviceImpl::FindVirtualQueue(Time& resumeAt) {
+  auto now = Simulator::Now();
+  auto count = m_stdQueues.size();
+  for(std::size_t i = 0; i < count; i++) {
+    auto index = (m_nextStdQueue + i) % count;
+    auto& voq = m_stdQueues[index];
+    if(voq.m_entries.empty()) {
+      continue;
+    }
+    if(voq.m_heldUntil > now) {
+      resumeAt = std::min(resumeAt, voq.m_heldUntil);
+      continue;
+    }
+    return index;
+  }
+  return count;
+}
+
+bool
+AntNetDevice::AntNetDeviceImpl::CodelOkToDrop(VirtualQueue& voq, Time now) {
+  auto sojourn = now - voq.m_entries.front().EnqueueTime();
+  // a single entry doesn't make a standing queue
+  if(sojourn < m_config->codelTarget || voq.m_entries.size() <= 1) {
+    voq.m_firstAboveTime = Seconds(0);
+    return false;
+  }
+
+  if(voq.m_firstAboveTime == Seconds(0)) {
+    // the sojourn time has to stay above the target for an interval
+    voq.m_firstAboveTime = now + m_config->codelInterval;
+    return false;
+  }
+  return now >= voq.m_firstAboveTime;
+}
+
+Time
+AntNetDevice::AntNetDeviceImpl::CodelControlLaw(Time t, uint32_t count) {
+  return t + Seconds(m_config->codelInterval.GetSeconds() / std::sqrt(count));
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::CodelDequeue(VirtualQueue& voq) {
+  if(voq.m_entries.empty()) {
+    voq.m_dropping = false;
+    return;
+  }
+
+  auto now = Simulator::Now();
+  auto okToDrop = CodelOkToDrop(voq, now);
+  if(voq.m_dropping) {
+    if(!okToDrop) {
+      // the sojourn time dropped below the target, leave the dropping state
+      voq.m_dropping = false;
+      return;
+    }
+
+    // drop at the pace of the control law until the queue recovers
+    while(now >= voq.m_dropNext && voq.m_dropping) {
+      DropFront(voq);
+      voq.m_count++;
+      if(voq.m_entries.empty() || !CodelOkToDrop(voq, now)) {
+        voq.m_dropping = false;
+        return;
+      }
+      voq.m_dropNext = CodelControlLaw(voq.m_dropNext, voq.m_count);
+    }
+    return;
+  }
+
+  if(okToDrop) {
+    DropFront(voq);
+    voq.m_dropping = true;
+    // start from the drop rate of the previous dropping state if it ended recently
+    auto delta = voq.m_count - voq.m_lastCount;
+    auto recent = now - voq.m_dropNext < m_config->codelInterval * 16;
+    voq.m_count = delta > 1 && recent ? delta : 1;
+    voq.m_lastCount = voq.m_count;
+    voq.m_dropNext = CodelControlLaw(now, voq.m_count);
+  }
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::DropFront(VirtualQueue& voq) {
+  NS_LOG_DEBUG("Dropped packet after " << (Simulator::Now() - voq.m_entries.front().EnqueueTime()) << " in the queue");
+  m_dropTrace(voq.m_entries.front().GetPacket(), Lane::Standard, DropReason::Aqm);
+  voq.m_entries.pop();
+  m_stdQueueSize--;
+  StateOf(Lane::Standard).m_statistics.m_aqmDrops++;
+  UpdateQueueLengths();
+}
+
+bool
+AntNetDevice::AntNetDeviceImpl::AntTypeOf(SendQueueEntry& entry, AntType& type) {
+  // the ants of unicast entries are still carried in udp, reading behind
+  // the udp header takes a copy
+  Ptr<const Packet> packet = entry.GetPacket();
+  auto unicast = entry.AsUnicast();
+  if(unicast != nullptr) {
+    if(unicast->GetHeader().GetProtocol() != UdpL4Protocol::PROT_NUMBER) {
+      return false;
+    }
+    Ptr<Packet> copy = packet->Copy();
+    UdpHeader udpHeader;
+    copy->RemoveHeader(udpHeader);
+    if(udpHeader.GetDestinationPort() != AnthocnetRouting::ANTHOCNET_PORT) {
+      return false;
+    }
+    packet = copy;
+  }
+
+  AntTypeHeader typeHeader;
+  packet->PeekHeader(typeHeader);
+  type = typeHeader.GetAntType();
+  return true;
+}
+
+Time
+AntNetDevice::AntNetDeviceImpl::LifetimeOf(Lane lane, SendQueueEntry& entry) {
+  if(lane == Lane::Standard) {
+    return m_config->dataLifetime;
+  }
+
+  auto lifetime = m_config->antLifetime;
+  AntType type;
+  if((m_config->backwardAntLifetime == Seconds(0) && m_config->helloLifetime == Seconds(0))
+     || !AntTypeOf(entry, type)) {
+    return lifetime;
+  }
+
+  auto specific = Seconds(0);
+  switch(type) {
+    case AntType::BackwardAnt:
+      specific = m_config->backwardAntLifetime;
+      break;
+    case AntType::HelloAnt:
+      specific = m_config->helloLifetime;
+      break;
+    default:
+      break;
+  }
+  return specific > Seconds(0) ? specific : lifetime;
 }
 
 void
-AntNetDevice::AntNetDeviceImpl::SubmitTo(std::shared_ptr<SendQueueEntry> entry, SendQueue& queue) {
-  bool idle = IsIdle();
-  queue.push(entry);
-  if(idle) {
-    NS_LOG_UNCOND("Idle queue - sending next packet");
-    SendNext();
+AntNetDevice::AntNetDeviceImpl::SetDeadline(Lane lane, SendQueueEntry& entry) {
+  if(entry.Deadline() != Time::Max()) {
+    return; // set by the submitter
+  }
+
+  auto lifetime = LifetimeOf(lane, entry);
+  if(lifetime > Seconds(0)) {
+    entry.Deadline(Simulator::Now() + lifetime);
+  }
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::DropExpired(Lane lane, SendQueue& queue) {
+  auto now = Simulator::Now();
+  auto& statistics = StateOf(lane).m_statistics;
+  while(!queue.empty() && queue.front().Deadline() < now) {
+    m_dropTrace(queue.front().GetPacket(), lane, DropReason::Expired);
+    queue.pop();
+    statistics.m_expiredDrops++;
+    if(lane == Lane::Standard) {
+      m_stdQueueSize--;
+    }
+  }
+  UpdateQueueLengths();
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::ReapExpired(Lane lane) {
+  if(lane == Lane::Expedited) {
+    ReapExpired(lane, m_fastQueue);
+  } else {
+    for(auto& voq : m_stdQueues) {
+      ReapExpired(lane, voq.m_entries);
+    }
+  }
+  UpdateQueueLengths();
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::ReapExpired(Lane lane, SendQueue& queue) {
+  auto now = Simulator::Now();
+  auto& statistics = StateOf(lane).m_statistics;
+  SendQueue kept(queue.capacity());
+  for(std::size_t i = 0; i < queue.size(); i++) {
+    auto& entry = queue[i];
+    bool inFlight = i == 0 && m_inFlight == &queue;
+    if(inFlight || entry.Deadline() >= now) {
+      kept.push(std::move(entry));
+      continue;
+    }
+    m_dropTrace(entry.GetPacket(), lane, DropReason::Expired);
+    statistics.m_expiredDrops++;
+    if(lane == Lane::Standard) {
+      m_stdQueueSize--;
+    }
+  }
+  queue = std::move(kept);
+}
+
+std::size_t
+AntNetDevice::AntNetDeviceImpl::Pending(Lane lane) {
+  std::size_t size = lane == Lane::Expedited ? m_fastQueue.size() : m_stdQueueSize;
+  bool inFlight = m_inFlight != nullptr && (m_inFlightVoq == nullptr) == (lane == Lane::Expedited);
+  return inFlight ? size - 1 : size;
+}
+
+AntNetDevice::Lane
+AntNetDevice::AntNetDeviceImpl::SelectLane(SendQueueEntry* fast, uint32_t fastSize, SendQueueEntry* standard) {
+  if(fast == nullptr || standard == nullptr) {
+    // a lane without backlog doesn't keep its deficit (note: the std lane
+    // might have entries in held queues)
+    auto idle = fast == nullptr ? Lane::Expedited : Lane::Standard;
+    if(Pending(idle) == 0) {
+      StateOf(idle).m_deficit = 0;
+    }
+    return fast == nullptr ? Lane::Standard : Lane::Expedited;
+  }
+
+  // a lane waiting for too long is served first
+  auto bound = m_config->laneStarvationBound;
+  if(bound > Seconds(0)) {
+    auto now = Simulator::Now();
+    auto fastWait = now - StateOf(Lane::Expedited).m_waitingSince;
+    auto stdWait = now - StateOf(Lane::Standard).m_waitingSince;
+    if(fastWait > bound || stdWait > bound) {
+      auto starved = fastWait >= stdWait ? Lane::Expedited : Lane::Standard;
+      StateOf(starved).m_statistics.m_starvationOverrides++;
+      return starved;
+    }
   }
+
+  return SelectByDeficit(fastSize, standard->GetPacket()->GetSize());
 }
 
+AntNetDevice::Lane
+AntNetDevice::AntNetDeviceImpl::SelectByDeficit(uint32_t fastSize, uint32_t standardSize) {
+  uint64_t fastQuantum = uint64_t(m_config->expeditedLaneWeight) * m_config->laneQuantum;
+  uint64_t stdQuantum = uint64_t(m_config->standardLaneWeight) * m_config->laneQuantum;
+
+  // a lane without weight only gets the remaining airtime (strict priority)
+  if(stdQuantum == 0) {
+    return Lane::Expedited;
+  }
+  if(fastQuantum == 0) {
+    return Lane::Standard;
+  }
+
+  // the lane having the turn sends as long as its deficit covers its head,
+  // then the turn passes to the other lane which receives its quantum
+  while(true) {
+    auto& state = StateOf(m_turn);
+    uint64_t size = m_turn == Lane::Expedited ? fastSize : standardSize;
+    if(state.m_deficit >= size) {
+      state.m_deficit -= size;
+      return m_turn;
+    }
+
+    m_turn = m_turn == Lane::Expedited ? Lane::Standard : Lane::Expedited;
+    StateOf(m_turn).m_deficit += m_turn == Lane::Expedited ? fastQuantum : stdQuantum;
+  }
+}
+
+std::size_t
+AntNetDevice::AntNetDeviceImpl::AggregateRun(uint32_t& frameSize) {
+  frameSize = m_fastQueue.front().GetPacket()->GetSize();
+  auto head = m_fastQueue.front().AsBroadcast();
+  if(head == nullptr) {
+    return 1;
+  }
+
+  // collect the run of broadcasts at the front queued within the window
+  auto start = m_fastQueue.front().EnqueueTime();
+  uint32_t size = frameSize;
+  std::size_t count = 1;
+  while(count < m_fastQueue.size() && count < AggregateHeader::MAX_ANTS) {
+    auto& entry = m_fastQueue[count];
+    auto broadcast = entry.AsBroadcast();
+    if(broadcast == nullptr || !head->SameDestination(*broadcast)
+       || entry.Deadline() < Simulator::Now()
+       || entry.EnqueueTime() - start > m_config->aggregationWindow
+       || size + broadcast->GetPacket()->GetSize() > m_config->maxAggregateSize) {
+      break;
+    }
+    size += broadcast->GetPacket()->GetSize();
+    count++;
+  }
+
+  if(count > 1) {
+    frameSize = AggregateHeader::GetAggregateSize(count, size);
+  }
+  return count;
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::AggregateBroadcasts(std::size_t count) {
+  std::vector<Ptr<const Packet>> ants;
+  for(std::size_t i = 0; i < count; i++) {
+    ants.push_back(m_fastQueue[i].GetPacket());
+  }
+  auto aggregate = AggregateHeader::Pack(ants);
+
+  // the last entry of the run carries the aggregate, the others are removed.
+  // They are dequeued along with the carrier.
+  auto now = Simulator::Now();
+  auto& state = StateOf(Lane::Expedited);
+  auto start = m_fastQueue.front().EnqueueTime();
+  auto& last = m_fastQueue[count - 1];
+  last.AsBroadcast()->SetPacket(aggregate);
+  last.EnqueueTime(start);
+  for(std::size_t i = 0; i < count - 1; i++) {
+    auto sojourn = now - m_fastQueue.front().EnqueueTime();
+    state.m_sojourn.Add(sojourn);
+    m_dequeueTrace(m_fastQueue.front().GetPacket(), Lane::Expedited, sojourn);
+    m_fastQueue.pop();
+  }
+  StateOf(Lane::Expedited).m_statistics.m_aggregated += count - 1;
+  UpdateQueueLengths();
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::SendFront(Lane lane, SendQueue& queue, VirtualQueue* voq) {
+  m_inFlight = &queue;
+  m_inFlightVoq = voq;
+
+  auto& nxt = queue.front();
+  auto now = Simulator::Now();
+
+  // the next entry of the lane starts waiting now
+  auto& state = StateOf(lane);
+  auto wait = now - state.m_waitingSince;
+  state.m_statistics.m_sent++;
+  state.m_statistics.m_bytes += nxt.GetPacket()->GetSize();
+  state.m_statistics.m_totalWait += wait;
+  state.m_statistics.m_maxWait = std::max(state.m_statistics.m_maxWait, wait);
+  state.m_waitingSince = now;
+
+  auto sojourn = now - nxt.EnqueueTime();
+  state.m_sojourn.Add(sojourn);
+  m_dequeueTrace(nxt.GetPacket(), lane, sojourn);
+
+  nxt.Sending(true);
+  nxt.SendStartTime(now);
+  if(m_config->watchdogEnabled) {
+    m_watchdogTimer.Schedule(WatchdogBound());
+  }
+  NS_LOG_UNCOND("Packet sent:" << *(nxt.GetPacket()));
+  m_inFlightAtMac = false;
+  nxt();
+}
 
 void
 AntNetDevice::AntNetDeviceImpl::SendNext() {
-  // send function (to spare some lines of code -> issues with references)
+  if(!IsIdle()) {
+    return;
+  }
 
-  auto send = [] (auto nxt) {
-    nxt->Sending(true);
-    nxt->SendStartTime(Simulator::Now());
-    NS_LOG_UNCOND("Packet sent:" << *(nxt->GetPacket()));
-    (*nxt)();
-  };
+  // expired entries are skipped instead of using airtime
+  DropExpired(Lane::Expedited, m_fastQueue);
+
+  auto resumeAt = Time::Max();
+  auto index = FindVirtualQueue(resumeAt);
+  while(index < m_stdQueues.size()) {
+    // the expired entries and the aqm might empty the queue, look for the
+    // next one in that case
+    auto& voq = m_stdQueues[index];
+    DropExpired(Lane::Standard, voq.m_entries);
+    if(m_config->codelEnabled) {
+      CodelDequeue(voq);
+    }
+    if(!voq.m_entries.empty()) {
+      break;
+    }
+    index = FindVirtualQueue(resumeAt);
+  }
+  auto voq = index < m_stdQueues.size() ? &m_stdQueues[index] : nullptr;
+  auto fast = m_fastQueue.empty() ? nullptr : &m_fastQueue.front();
+  auto standard = voq == nullptr ? nullptr : &voq->m_entries.front();
+
+  // the lanes are scheduled on the frame the expedited lane would send, the
+  // aggregate rather than its first ant
+  uint32_t fastSize = 0;
+  std::size_t aggregateCount = 1;
+  if(fast != nullptr) {
+    fastSize = fast->GetPacket()->GetSize();
+    if(m_config->broadcastAggregation) {
+      aggregateCount = AggregateRun(fastSize);
+    }
+  }
 
-  if(!m_fastQueue.empty()) {
+  if(fast == nullptr && standard == nullptr) {
+    // only held queues have pending entries, continue once the first one is released
+    if(resumeAt != Time::Max() && !m_resumeTimer.IsRunning()) {
+      m_resumeTimer.Schedule(resumeAt - Simulator::Now());
+    }
+    // do nothing if no pending packets available.
+    return;
+  }
+
+  if(SelectLane(fast, fastSize, standard) == Lane::Expedited) {
     NS_LOG_UNCOND("Sending from fast queue");
-    auto nxt = m_fastQueue.front();
-    send(nxt);
+    if(aggregateCount > 1) {
+      AggregateBroadcasts(aggregateCount);
+    }
+    SendFront(Lane::Expedited, m_fastQueue, nullptr);
+    return;
+  }
+
+  NS_LOG_UNCOND("Sending from std queue:");
+  m_nextStdQueue = index + 1;
+  SendFront(Lane::Standard, voq->m_entries, voq);
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::CompleteInFlight() {
+  m_watchdogTimer.Cancel();
+  m_inFlight->pop();
+  if(m_inFlightVoq != nullptr) {
+    m_stdQueueSize--;
+  }
+  m_inFlight = nullptr;
+  m_inFlightVoq = nullptr;
+  UpdateQueueLengths();
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::Resume() {
+  SendNext();
+}
+
+Time
+AntNetDevice::AntNetDeviceImpl::WatchdogBound() {
+  auto bound = Seconds(m_config->watchdogFactor * m_sendTimeEst.GetSeconds());
+  return std::max(bound, m_config->watchdogMinimum);
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::WatchdogExpire() {
+  if(IsIdle()) {
     return;
   }
 
-  if(!m_stdQueue.empty()) {
-    NS_LOG_UNCOND("Sending from std queue:");
-    auto nxt = m_stdQueue.front();
-    send(nxt);
+  // should the mac still report on the frame, the report must not be taken
+  // for the entry sent next
+  auto lane = m_inFlightVoq == nullptr ? Lane::Expedited : Lane::Standard;
+  NS_LOG_DEBUG("Watchdog expired, no report from the mac since " << m_inFlight->front().SendStartTime().GetSeconds());
+  StateOf(lane).m_statistics.m_stalls++;
+  if(m_inFlightAtMac) {
+    m_lateReports++;
+    m_lateReportsUntil = Simulator::Now() + WatchdogBound();
+  } else {
+    m_stalledUids.push_back(m_inFlight->front().GetPacket()->GetUid());
+    if(m_stalledUids.size() > MAX_STALLED_UIDS) {
+      m_stalledUids.pop_front();
+    }
+  }
+  FailInFlight(DropReason::Stalled);
+}
+
+bool
+AntNetDevice::AntNetDeviceImpl::LateReport() {
+  if(m_lateReports == 0) {
+    return false;
+  }
+  if(Simulator::Now() > m_lateReportsUntil) {
+    m_lateReports = 0;
+    return false;
+  }
+
+  NS_LOG_DEBUG("Ignored a late report of the mac on a stalled entry");
+  m_lateReports--;
+  return true;
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::MacTxCallback(Ptr<const Packet> p) {
+  auto uid = p->GetUid();
+  if(!IsIdle() && m_inFlight->front().GetPacket()->GetUid() == uid) {
+    m_inFlightAtMac = true;
     return;
   }
 
-  // do nothing if no pending packets available.
+  // a failed entry reached the mac after all, the mac reports on it
+  auto stalled = std::find(m_stalledUids.begin(), m_stalledUids.end(), uid);
+  if(stalled != m_stalledUids.end()) {
+    m_stalledUids.erase(stalled);
+    m_lateReports++;
+    m_lateReportsUntil = Simulator::Now() + WatchdogBound();
+  }
 }
 
 void
@@ -137,13 +768,14 @@ AntNetDevice::AntNetDeviceImpl::HookupTraces(Ptr<NetDevice> device) {
   }
 
   // hookup the delivery callbacks.
-  // note: since we do spoon feed the mac layer, we need no callbacks for when
-  // the mac layer is starting the transaction.
+  // note: since we do spoon feed the mac layer, the frames reaching the mac
+  // are only traced to tell the late reports on failed entries apart.
   Ptr<WifiNetDevice> wifiDev = device -> GetObject<WifiNetDevice>();
   Ptr<WifiMac> wifiMac = wifiDev -> GetMac();
   Ptr<RegularWifiMac> regWifiMac = wifiMac -> GetObject<RegularWifiMac>();
 
   //wifiMac -> TraceConnectWithoutContext(MacTxDrop, MakeCallback(&AntNetDevice::AntNetDeviceImpl::MacTxDropCallback, this));
+  wifiMac -> TraceConnectWithoutContext(MacTx, MakeCallback(&AntNetDevice::AntNetDeviceImpl::MacTxCallback, this));
   regWifiMac -> TraceConnectWithoutContext(TxErrHeader, MakeCallback(&AntNetDevice::AntNetDeviceImpl::TxErrHeaderCallback, this));
   regWifiMac -> TraceConnectWithoutContext(TxOkHeader, MakeCallback(&AntNetDevice::AntNetDeviceImpl::TxOkHeaderCallback, this));
 
@@ -166,6 +798,7 @@ AntNetDevice::AntNetDeviceImpl::UnhookTraces(Ptr<NetDevice> device) {
 
 
   //wifiMac -> TraceDisconnectWithoutContext(MacTxDrop, MakeCallback(&AntNetDevice::AntNetDeviceImpl::MacTxDropCallback, this));
+  wifiMac -> TraceDisconnectWithoutContext(MacTx, MakeCallback(&AntNetDevice::AntNetDeviceImpl::MacTxCallback, this));
   regWifiMac -> TraceDisconnectWithoutContext(TxErrHeader, MakeCallback(&AntNetDevice::AntNetDeviceImpl::TxErrHeaderCallback, this));
   regWifiMac -> TraceDisconnectWithoutContext(TxOkHeader, MakeCallback(&AntNetDevice::AntNetDeviceImpl::TxOkHeaderCallback, this));
 }
@@ -179,12 +812,18 @@ AntNetDevice::AntNetDeviceImpl::MacTxDropCallback(Ptr<const Packet> p) {
 // capturer for failure of sending
 void
 AntNetDevice::AntNetDeviceImpl::TxErrHeaderCallback(const WifiMacHeader& h) {
+  if(LateReport()) {
+    return;
+  }
   DroppedPacketCallback();
 }
 
 // capturer for successful sending (returns afer unsuccesful sending)
 void
 AntNetDevice::AntNetDeviceImpl::TxOkHeaderCallback(const WifiMacHeader& h) {
+  if(LateReport()) {
+    return;
+  }
   DeliveredPacketCallback();
 }
 
@@ -193,77 +832,117 @@ AntNetDevice::AntNetDeviceImpl::TxOkHeaderCallback(const WifiMacHeader& h) {
 void
 AntNetDevice::AntNetDeviceImpl::DroppedPacketCallback() {
 
-  if(!m_stdQueue.empty() && m_stdQueue.front()->Sending()) {
-    auto frontEntry = std::dynamic_pointer_cast<UnicastQueueEntry>(m_stdQueue.front());
-    if (frontEntry != nullptr) {
+  if(IsIdle()) {
+    //NS_LOG_WARN("Warning: " << m_device -> GetAddress() << " receive dropped callback without any sending entries in the standard or fast queue");
+    return;
+  }
+
+  auto lane = m_inFlightVoq == nullptr ? Lane::Expedited : Lane::Standard;
+  StateOf(lane).m_statistics.m_macFailures++;
+  m_macTxErrorTrace(m_inFlight->front().GetPacket(), lane);
+  FailInFlight(DropReason::MacFailure);
+}
+
+void
+AntNetDevice::AntNetDeviceImpl::FailInFlight(DropReason reason) {
+  auto lane = m_inFlightVoq == nullptr ? Lane::Expedited : Lane::Standard;
+  m_dropTrace(m_inFlight->front().GetPacket(), lane, reason);
+
+  if(m_inFlightVoq != nullptr) {
+    // the next hop probably moved away, serve the other next hops first
+    m_inFlightVoq->m_heldUntil = Simulator::Now() + m_config->nextHopHoldTime;
+
+    auto frontEntry = m_inFlight->front().AsUnicast();
+    if (frontEntry != nullptr && frontEntry -> GetRoute()) {
       auto source = frontEntry -> GetRoute() -> GetSource();
       auto dest = frontEntry -> GetRoute() -> GetDestination();
       if( m_routeRepairCallback) {
         NS_LOG_UNCOND("Submitted route repair ant");
         auto entry = m_routeRepairCallback(source, dest);
         NS_LOG_UNCOND("RouteRepair callback - source" << source);
-        SubmitExpedited(entry);
+        SubmitExpedited(std::move(entry));
       }
     }
   }
 
-  if(!m_fastQueue.empty() && m_fastQueue.front()->Sending()) {
-    m_fastQueue.pop();
-    SendNext();
-  }
-
-  if(!m_stdQueue.empty() && m_stdQueue.front()->Sending()) {
-    m_stdQueue.pop();
-    SendNext();
-  }
-
-  //NS_LOG_WARN("Warning: " << m_device -> GetAddress() << " receive dropped callback without any sending entries in the standard or fast queue");
+  CompleteInFlight();
+  SendNext();
 }
 
 // callback to be called when the transmission was successful
 void
 AntNetDevice::AntNetDeviceImpl::DeliveredPacketCallback() {
 
-  auto handleSent = [this] (SendQueue& queue) {
-    auto elapsedTime = Simulator::Now() - queue.front()->SendStartTime();
-    m_sendTimeEst = Seconds(s_alpha * m_sendTimeEst.GetSeconds() + (1 - s_alpha) * elapsedTime.GetSeconds());
-    queue.pop();
-    SendNext();
-  };
-
-  if(!m_fastQueue.empty() && m_fastQueue.front()->Sending()) {
-    handleSent(m_fastQueue);
+  if(IsIdle()) {
+    //NS_LOG_WARN("Warning: " << m_device -> GetAddress() << "received 'DeliveredPacketCallback' without any sending entries in the standard or fast queue");
     return;
   }
 
-  if(!m_stdQueue.empty() && m_stdQueue.front()->Sending()) {
-    handleSent(m_stdQueue);
-    return;
+  auto elapsedTime = Simulator::Now() - m_inFlight->front().SendStartTime();
+  auto alpha = m_config->alpha;
+  m_sendTimeEst = Seconds(alpha * m_sendTimeEst.GetSeconds() + (1 - alpha) * elapsedTime.GetSeconds());
+  // the neighbors hear the node anyway if it sent more than its hellos. The
+  // hellos are broadcast, the other entries need not be read.
+  if(m_config->helloSuppression) {
+    auto& entry = m_inFlight->front();
+    AntType type;
+    if(entry.AsBroadcast() == nullptr || !AntTypeOf(entry, type) || type != AntType::HelloAnt) {
+      m_lastTransmission = Simulator::Now();
+    }
   }
-
-  //NS_LOG_WARN("Warning: " << m_device -> GetAddress() << "received 'DeliveredPacketCallback' without any sending entries in the standard or fast queue");
+  CompleteInFlight();
+  SendNext();
 }
 
 void
-AntNetDevice::AntNetDeviceImpl::Submit(std::shared_ptr<SendQueueEntry> entry) {
-  if(m_stdQueue.size() > AntNetDevice::MaxQueueSize()) {
-    return; // drop the packet. TODO do we add a trace source for this?
+AntNetDevice::AntNetDeviceImpl::Submit(SendQueueEntry entry) {
+  if(m_stdQueueSize > m_config->maxQueueSize) {
+    // make room from the expired entries before refusing a fresh one
+    ReapExpired(Lane::Standard);
+  }
+  if(m_stdQueueSize > m_config->maxQueueSize) {
+    // drop the packet
+    StateOf(Lane::Standard).m_statistics.m_overflowDrops++;
+    m_dropTrace(entry.GetPacket(), Lane::Standard, DropReason::QueueFull);
+    return;
   }
 
   NS_LOG_UNCOND("Submitted normal packet");
 
-  SubmitTo(entry, m_stdQueue);
+  if(Pending(Lane::Standard) == 0) {
+    StateOf(Lane::Standard).m_waitingSince = Simulator::Now();
+  }
+  entry.EnqueueTime(Simulator::Now());
+  SetDeadline(Lane::Standard, entry);
+  m_enqueueTrace(entry.GetPacket(), Lane::Standard);
+  QueueFor(entry.NextHop()).m_entries.push(std::move(entry));
+  m_stdQueueSize++;
+  UpdateQueueLengths();
+  SendNext();
 }
 
 void
-AntNetDevice::AntNetDeviceImpl::SubmitExpedited(std::shared_ptr<SendQueueEntry> entry) {
-  if(m_fastQueue.size() > AntNetDevice::MaxQueueSize()) {
+AntNetDevice::AntNetDeviceImpl::SubmitExpedited(SendQueueEntry entry) {
+  if(m_fastQueue.size() > m_config->maxQueueSize) {
+    ReapExpired(Lane::Expedited);
+  }
+  if(m_fastQueue.size() > m_config->maxQueueSize) {
+    StateOf(Lane::Expedited).m_statistics.m_overflowDrops++;
+    m_dropTrace(entry.GetPacket(), Lane::Expedited, DropReason::QueueFull);
     return;
   }
 
   NS_LOG_UNCOND("Submitted expedited entry, queue size: " << m_fastQueue.size());
 
-  SubmitTo(entry, m_fastQueue);
+  if(Pending(Lane::Expedited) == 0) {
+    StateOf(Lane::Expedited).m_waitingSince = Simulator::Now();
+  }
+  entry.EnqueueTime(Simulator::Now());
+  SetDeadline(Lane::Expedited, entry);
+  m_enqueueTrace(entry.GetPacket(), Lane::Expedited);
+  m_fastQueue.push(std::move(entry));
+  UpdateQueueLengths();
+  SendNext();
 }
 
 // AntNetDevice definition -----------------------------------------------------
@@ -271,15 +950,13 @@ AntNetDevice::AntNetDeviceImpl::SubmitExpedited(std::shared_ptr<SendQueueEntry>
 // constexpr std::string AntNetDevice::MacTxDrop = "MacTxDrop";
 // constexpr std::string AntNetDevice::TxOkHeader = "TxOkHeader";
 // constexpr std::string AntNetDevice::TxErrHeader = "TxErrHeader";
-// static variable definition --------------------------------------------------
-double AntNetDevice::s_alpha = 0.7; // [0, 7]
-std::size_t AntNetDevice::s_maxQueueSize = DEFAULT_MAX_QUEUESIZE;
-bool AntNetDevice::s_repairEnabled;
-
 // method definition -----------------------------------------------------------
 AntNetDevice::AntNetDevice() : AntNetDevice(Ptr<NetDevice>()) { }
 
-AntNetDevice::AntNetDevice(Ptr<NetDevice> device) : m_impl(std::make_shared<AntNetDeviceImpl>(device)) { }
+AntNetDevice::AntNetDevice(Ptr<NetDevice> device) : AntNetDevice(device, AnthocnetConfig::Defaults()) { }
+
+AntNetDevice::AntNetDevice(Ptr<NetDevice> device, std::shared_ptr<AnthocnetConfig> config)
+  : m_impl(std::make_shared<AntNetDeviceImpl>(device, config)) { }
 
 AntNetDevice::~AntNetDevice() { }
 
@@ -299,20 +976,44 @@ AntNetDevice::Device(Ptr<NetDevice> device) {
 }
 
 void
-AntNetDevice::Submit(std::shared_ptr<SendQueueEntry> entry) {
-  m_impl -> Submit(entry);
+AntNetDevice::Submit(SendQueueEntry entry) {
+  m_impl -> Submit(std::move(entry));
 }
 
 
 void
-AntNetDevice::SubmitExpedited(std::shared_ptr<SendQueueEntry> entry) {
-  m_impl -> SubmitExpedited(entry);
+AntNetDevice::SubmitExpedited(SendQueueEntry entry) {
+  m_impl -> SubmitExpedited(std::move(entry));
+}
+
+void
+AntNetDevice::NotifyMacTx(Ptr<const Packet> packet) {
+  m_impl -> MacTxCallback(packet);
+}
+
+void
+AntNetDevice::NotifyTxOk() {
+  m_impl -> TxOkHeaderCallback(WifiMacHeader());
+}
+
+void
+AntNetDevice::NotifyTxError() {
+  m_impl -> TxErrHeaderCallback(WifiMacHeader());
 }
 
 // returns the size of the std queue (not used to expedite ants)
 std::size_t
 AntNetDevice::QueueSize() {
-  return m_impl -> m_stdQueue.size();
+  return m_impl -> m_stdQueueSize;
+}
+
+std::size_t
+AntNetDevice::QueueSize(Ipv4Address nextHop) {
+  auto it = m_impl -> m_stdQueueIndex.find(nextHop);
+  if(it == m_impl -> m_stdQueueIndex.end()) {
+    return 0;
+  }
+  return m_impl -> m_stdQueues[it->second].m_entries.size();
 }
 
 // moving average of the send time of the node
@@ -321,14 +1022,49 @@ AntNetDevice::SendingTimeEst() {
   return m_impl -> m_sendTimeEst;
 }
 
+Time
+AntNetDevice::LastTransmission() {
+  return m_impl -> m_lastTransmission;
+}
+
 std::size_t
 AntNetDevice::MaxQueueSize() {
-  return s_maxQueueSize;
+  return AnthocnetConfig::Defaults()->maxQueueSize;
 }
 
 void
 AntNetDevice::MaxQueueSize(std::size_t maxQueueSize) {
-  s_maxQueueSize = maxQueueSize;
+  AnthocnetConfig::Defaults()->maxQueueSize = maxQueueSize;
+}
+
+LaneStatistics
+AntNetDevice::GetLaneStatistics(Lane lane) {
+  return m_impl -> StateOf(lane).m_statistics;
+}
+
+SojournHistogram
+AntNetDevice::GetSojournHistogram(Lane lane) {
+  return m_impl -> StateOf(lane).m_sojourn;
+}
+
+bool
+AntNetDevice::TraceConnectWithoutContext(std::string name, const CallbackBase& cb) {
+  if(name == "Enqueue") {
+    m_impl -> m_enqueueTrace.ConnectWithoutContext(cb);
+  } else if(name == "Dequeue") {
+    m_impl -> m_dequeueTrace.ConnectWithoutContext(cb);
+  } else if(name == "Drop") {
+    m_impl -> m_dropTrace.ConnectWithoutContext(cb);
+  } else if(name == "MacTxError") {
+    m_impl -> m_macTxErrorTrace.ConnectWithoutContext(cb);
+  } else if(name == "ExpeditedQueueLength") {
+    m_impl -> m_fastQueueLength.ConnectWithoutContext(cb);
+  } else if(name == "StandardQueueLength") {
+    m_impl -> m_stdQueueLength.ConnectWithoutContext(cb);
+  } else {
+    return false;
+  }
+  return true;
 }
 
 void
@@ -338,24 +1074,72 @@ AntNetDevice::SetRouteRepairCallback(RouteRepairCallback rrcb) {
 
 double
 AntNetDevice::GetAlpha() {
-  return s_alpha;
+  return AnthocnetConfig::Defaults()->alpha;
 }
 
 void
 AntNetDevice::SetAlpha(double alpha) {
-  s_alpha = alpha;
+  AnthocnetConfig::Defaults()->alpha = alpha;
 }
 
 bool
 AntNetDevice::GetRepairEnabled() {
-  return s_repairEnabled;
+  return AnthocnetConfig::Defaults()->repairEnabled;
 }
 
 void
 AntNetDevice::SetRepairEnabled(bool enabled) {
-  s_repairEnabled = enabled;
+  AnthocnetConfig::Defaults()->repairEnabled = enabled;
+}
+
+
+// SojournHistogram definition ------------------------------------------------
+SojournHistogram::SojournHistogram(Time binWidth, uint32_t bins)
+  : m_binWidth(binWidth), m_bins(bins ? bins : 1, 0), m_count(0), m_total(Seconds(0)), m_max(Seconds(0)) { }
+
+void
+SojournHistogram::Add(Time sojourn) {
+  auto index = static_cast<uint64_t>(sojourn.GetNanoSeconds() / std::max<int64_t>(m_binWidth.GetNanoSeconds(), 1));
+  m_bins[std::min<uint64_t>(index, m_bins.size() - 1)]++;
+  m_count++;
+  m_total += sojourn;
+  m_max = std::max(m_max, sojourn);
+}
+
+uint32_t
+SojournHistogram::GetNBins() const {
+  return m_bins.size();
 }
 
+Time
+SojournHistogram::GetBinStart(uint32_t index) const {
+  return m_binWidth * index;
+}
+
+Time
+SojournHistogram::GetBinWidth() const {
+  return m_binWidth;
+}
+
+uint64_t
+SojournHistogram::GetBinCount(uint32_t index) const {
+  return m_bins.at(index);
+}
+
+uint64_t
+SojournHistogram::GetCount() const {
+  return m_count;
+}
+
+Time
+SojournHistogram::GetAverage() const {
+  return m_count == 0 ? Seconds(0) : NanoSeconds(m_total.GetNanoSeconds() / static_cast<int64_t>(m_count));
+}
+
+Time
+SojournHistogram::GetMax() const {
+  return m_max;
+}
 
 ExpeditedTag::ExpeditedTag(uint8_t expedited)
   : m_expedited(expedited) {
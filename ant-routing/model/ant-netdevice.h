@@ -2,37 +2,143 @@
 #define ANT_NETDEVICE_H
 
 #include "send-queue-entry.h"
+#include "anthocnet-config.h"
+#include "ring-buffer.h"
 #include "ns3/wifi-module.h"
 #include "ns3/packet.h"
 #include <memory>
-#include <queue>
+#include <vector>
 
 namespace ns3 {
 namespace ant_routing {
 
 // callback function, used to notify the interested parties that sending
 // a certain packet has failed at the mac layer
-using RouteRepairCallback = std::function<std::shared_ptr<SendQueueEntry>(Ipv4Address, Ipv4Address)>;
+using RouteRepairCallback = std::function<SendQueueEntry(Ipv4Address, Ipv4Address)>;
+
+// scheduling statistics of a lane of the device
+struct LaneStatistics {
+  uint64_t m_sent = 0; // entries handed to the mac
+  uint64_t m_bytes = 0;
+  // time the head of the lane waited before being handed to the mac
+  Time m_totalWait;
+  Time m_maxWait;
+  // number of times the lane was served because of the starvation bound
+  uint64_t m_starvationOverrides = 0;
+  // number of entries dropped by the active queue management
+  uint64_t m_aqmDrops = 0;
+  // number of entries dropped because the lane was full
+  uint64_t m_overflowDrops = 0;
+  // number of entries the mac failed to deliver
+  uint64_t m_macFailures = 0;
+  // number of entries merged into the frame of another entry (aggregation)
+  uint64_t m_aggregated = 0;
+  // number of entries skipped because their deadline passed
+  uint64_t m_expiredDrops = 0;
+  // number of entries failed by the watchdog, the mac never reported on them
+  uint64_t m_stalls = 0;
+};
+
+// histogram of the time the entries of a lane spent in the queue before
+// being handed to the mac. The bins have a fixed width, the last bin also
+// counts the longer times.
+class SojournHistogram {
+public:
+  SojournHistogram(Time binWidth, uint32_t bins);
+
+  void Add(Time sojourn);
+
+  uint32_t GetNBins() const;
+  Time GetBinStart(uint32_t index) const;
+  Time GetBinWidth() const;
+  uint64_t GetBinCount(uint32_t index) const;
+
+  uint64_t GetCount() const;
+  Time GetAverage() const;
+  Time GetMax() const;
+
+private:
+  Time m_binWidth;
+  std::vector<uint64_t> m_bins;
+  uint64_t m_count;
+  Time m_total;
+  Time m_max;
+};
 
 class AntNetDevice {
 public:
+  // the expedited lane carries the ants, the standard lane the data packets
+  enum class Lane : uint8_t {
+    Expedited = 0,
+    Standard = 1,
+  };
+
+  // reason an entry is dropped by the device
+  enum class DropReason : uint8_t {
+    QueueFull = 0, // the lane was full when the entry was submitted
+    Aqm = 1, // dropped by the active queue management
+    MacFailure = 2, // the mac failed to deliver the entry
+    Expired = 3, // the deadline of the entry passed before it was sent
+    Stalled = 4, // the mac didn't report on the entry before the watchdog expired
+  };
+
   AntNetDevice();
   AntNetDevice(Ptr<NetDevice> device);
+  AntNetDevice(Ptr<NetDevice> device, std::shared_ptr<AnthocnetConfig> config);
 
  ~AntNetDevice();
 
   Ptr<NetDevice> Device();
   void Device(Ptr<NetDevice> device);
 
-  void Submit(std::shared_ptr<SendQueueEntry> entry);
-  void SubmitExpedited(std::shared_ptr<SendQueueEntry> entry);
+  void Submit(SendQueueEntry entry);
+  void SubmitExpedited(SendQueueEntry entry);
+
+  // reports the frames reaching the mac and the outcome of the entry handed
+  // to the mac, as the traces of the wifi mac do. Allows to drive the device
+  // without a wifi device.
+  void NotifyMacTx(Ptr<const Packet> packet);
+  void NotifyTxOk();
+  void NotifyTxError();
+
+  // constructs an entry of type T (unicast or broadcast) and submits it,
+  // the entry is stored inline in the queue
+  template<typename T, typename ...Args>
+  void Emplace(Args&&...args) {
+    Submit(MakeSendQueueEntry<T>(std::forward<Args>(args)...));
+  }
+
+  template<typename T, typename ...Args>
+  void EmplaceExpedited(Args&&...args) {
+    SubmitExpedited(MakeSendQueueEntry<T>(std::forward<Args>(args)...));
+  }
 
   // returns the size of the std queue (not used to expedite ants)
   std::size_t QueueSize();
+  // returns the number of entries in the std queue for the next hop
+  std::size_t QueueSize(Ipv4Address nextHop);
 
   // moving average of the send time of the node
   Time SendingTimeEst();
-  //
+  // time of the last frame other than a hello delivered by the mac,
+  // Time::Min() if none yet. Only tracked with helloSuppression.
+  Time LastTransmission();
+
+  // statistics of the scheduling between the lanes
+  LaneStatistics GetLaneStatistics(Lane lane);
+  SojournHistogram GetSojournHistogram(Lane lane);
+
+  // connects a callback to one of the trace sources of the device, returns
+  // false if there is no trace source with the name:
+  //  - "Enqueue"    void (Ptr<const Packet>, Lane)
+  //  - "Dequeue"    void (Ptr<const Packet>, Lane, Time sojourn), the entry is handed to the mac.
+  //                 The ants merged into an aggregate are dequeued one by one,
+  //                 followed by the entry carrying the aggregate packet.
+  //  - "Drop"       void (Ptr<const Packet>, Lane, DropReason)
+  //  - "MacTxError" void (Ptr<const Packet>, Lane)
+  //  - "ExpeditedQueueLength", "StandardQueueLength" void (uint32_t old, uint32_t new)
+  bool TraceConnectWithoutContext(std::string name, const CallbackBase& cb);
+  // the static accessors operate on the default configuration
   static std::size_t MaxQueueSize();
   static void MaxQueueSize(std::size_t size);
 
@@ -45,16 +151,12 @@ public:
   static void SetRepairEnabled(bool enabled);
 
 private:
-  // the alpha value for calculating the average send time
-  static double s_alpha;
-  static std::size_t s_maxQueueSize;
-  static bool s_repairEnabled;
-
+  static constexpr const char* MacTx = "MacTx";
   static constexpr const char* MacTxDrop = "MacTxDrop";
   static constexpr const char* TxOkHeader = "TxOkHeader";
   static constexpr const char* TxErrHeader = "TxErrHeader";
-
-  static constexpr std::size_t DEFAULT_MAX_QUEUESIZE = 20;
+  // number of entries failed before reaching the mac which are remembered
+  static constexpr std::size_t MAX_STALLED_UIDS = 16;
 
   // Pimpl
   struct AntNetDeviceImpl;
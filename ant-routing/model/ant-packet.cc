@@ -463,5 +463,110 @@ std::ostream& operator <<(std::ostream& os, const LinkFailureNotification::Messa
 
 }
 
+// AggregateHeader definition -------------------------------------------------
+constexpr uint32_t AggregateHeader::MAX_ANTS;
+
+AggregateHeader::AggregateHeader() : m_lengths(std::vector<uint16_t>()) { }
+
+AggregateHeader::AggregateHeader(std::vector<uint16_t> lengths) : m_lengths(lengths) { }
+
+TypeId AggregateHeader::GetTypeId () {
+  static TypeId tid = TypeId ("ns3::ant_routing::AggregateHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("AntRouting")
+    .AddConstructor<AggregateHeader>();
+  return tid;
+}
+
+TypeId AggregateHeader::GetInstanceTypeId () const {
+  return GetTypeId();
+}
+
+uint32_t AggregateHeader::GetSerializedSize () const {
+  return sizeof(uint8_t) + m_lengths.size() * sizeof(uint16_t);
+}
+
+void AggregateHeader::Serialize (Buffer::Iterator i) const {
+  i.WriteU8(static_cast<uint8_t>(m_lengths.size()));
+  for(auto length : m_lengths) {
+    i.WriteHtonU16(length);
+  }
+}
+
+uint32_t AggregateHeader::Deserialize (Buffer::Iterator start) {
+  auto i = start;
+  uint8_t count = i.ReadU8();
+  m_lengths.clear();
+  for(uint8_t j = 0; j < count; j++) {
+    m_lengths.push_back(i.ReadNtohU16());
+  }
+  uint32_t dist = i.GetDistanceFrom(start);
+  NS_ASSERT(dist == GetSerializedSize());
+  return dist;
+}
+
+void AggregateHeader::Print (std::ostream &os) const {
+  os << "aggregate of " << m_lengths.size() << " ants";
+}
+
+std::vector<uint16_t> AggregateHeader::GetLengths() const {
+  return m_lengths;
+}
+
+void AggregateHeader::AddLength(uint16_t length) {
+  NS_ASSERT(m_lengths.size() < MAX_ANTS);
+  m_lengths.push_back(length);
+}
+
+uint32_t AggregateHeader::GetAggregateSize(uint32_t count, uint32_t antBytes) {
+  return AntTypeHeader().GetSerializedSize() + sizeof(uint8_t) + count * sizeof(uint16_t) + antBytes;
+}
+
+Ptr<Packet> AggregateHeader::Pack(const std::vector<Ptr<const Packet>>& ants) {
+  AggregateHeader header;
+  Ptr<Packet> aggregate = Create<Packet>();
+  for(auto ant : ants) {
+    header.AddLength(ant->GetSize());
+    aggregate->AddAtEnd(ant);
+  }
+  aggregate->AddHeader(header);
+  aggregate->AddHeader(AntTypeHeader(AntType::AggregateAnt));
+  return aggregate;
+}
+
+bool AggregateHeader::Unpack(Ptr<Packet> aggregate, std::vector<Ptr<Packet>>& ants) {
+  // the header itself might be cut short
+  uint8_t count = 0;
+  if(aggregate->CopyData(&count, 1) != 1 || aggregate->GetSize() < sizeof(uint8_t) + count * sizeof(uint16_t)) {
+    return false;
+  }
+
+  AggregateHeader header;
+  aggregate->RemoveHeader(header);
+  uint32_t offset = 0;
+  bool intact = true;
+  for(auto length : header.GetLengths()) {
+    if(offset + length > aggregate->GetSize()) {
+      return false;
+    }
+    auto ant = aggregate->CreateFragment(offset, length);
+    offset += length;
+
+    // aggregates are not nested
+    AntTypeHeader typeHeader;
+    if(length < typeHeader.GetSerializedSize()) {
+      intact = false;
+      continue;
+    }
+    ant->PeekHeader(typeHeader);
+    if(typeHeader.GetAntType() == AntType::AggregateAnt) {
+      intact = false;
+      continue;
+    }
+    ants.push_back(ant);
+  }
+  return intact;
+}
+
 } // namespace ant_routing
 } // namespace
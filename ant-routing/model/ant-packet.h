@@ -7,6 +7,7 @@
 #include "ns3/header.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/nstime.h"
+#include "ns3/packet.h"
 
 namespace ns3 {
 namespace ant_routing {
@@ -20,6 +21,7 @@ enum class AntType : uint8_t
   RouteRepairAnt = 4,
   HelloAnt = 5,
   LinkFailureAnt = 6,
+  AggregateAnt = 7, // container of several broadcast ants
 };
 
 // AntTypeHeader ----------------------------------------------------------------
@@ -211,6 +213,43 @@ inline bool operator==(const LinkFailureNotification::Message& lhs, const LinkFa
     && lhs.bestHopEstimate == rhs.bestHopEstimate;
 }
 
+// Aggregate declaration -------------------------------------------------------
+// header of an aggregate of ants, sent as a single broadcast frame. The header
+// holds the lengths of the ants, the ants (each with their own type header)
+// follow the header back to back.
+class AggregateHeader : public Header {
+public:
+  AggregateHeader();
+  AggregateHeader(std::vector<uint16_t> lengths);
+
+  static TypeId GetTypeId ();
+  TypeId GetInstanceTypeId () const;
+  uint32_t GetSerializedSize () const;
+  void Serialize (Buffer::Iterator start) const;
+  uint32_t Deserialize (Buffer::Iterator start);
+  void Print (std::ostream &os) const;
+
+  std::vector<uint16_t> GetLengths() const;
+  void AddLength(uint16_t length);
+
+  // maximal number of ants in a single aggregate
+  static constexpr uint32_t MAX_ANTS = 255;
+
+  // size of an aggregate packet (type header included) holding count ants
+  // of antBytes together
+  static uint32_t GetAggregateSize(uint32_t count, uint32_t antBytes);
+  // packs the ants (each starting with its type header) into an aggregate
+  // packet, starting with the type header of the aggregate
+  static Ptr<Packet> Pack(const std::vector<Ptr<const Packet>>& ants);
+  // splits an aggregate packet (its type header already removed) into its
+  // ants. Returns false if the aggregate is truncated or holds an aggregate,
+  // the ants that are complete (and no aggregates) are returned anyway.
+  static bool Unpack(Ptr<Packet> aggregate, std::vector<Ptr<Packet>>& ants);
+
+private:
+  std::vector<uint16_t> m_lengths;
+};
+
 } // namespace ant_routing
 } // namespace
 #endif /* ANTPACKET_H */
@@ -1,5 +1,10 @@
 #include "ant-routing-table.h"
+#include "pheromone-kernel.h"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -96,47 +101,786 @@ bool operator==(const NeighborKey &lhs, const NeighborKey& rhs) {
 }
 
 
-// AntRoutingTable definition --------------------------------------------------
-// static variables:
-double AntRoutingTable::s_antBeta = 1.0;
-double AntRoutingTable::s_packetBeta = 2.0;
-double AntRoutingTable::s_gamma = 0.7; // [0, 1]
-Time   AntRoutingTable::s_hopTime = MilliSeconds(3);
-double AntRoutingTable::s_bestEstCoeff = 0.7; // [0, 1]
-double AntRoutingTable::s_rho = 0.5;
+// AntRoutingTableImpl definition ----------------------------------------------
+// Neighbors and destinations are mapped onto small dense indices. The pheromone
+// entries are kept in a destination-major matrix stored as a structure of arrays,
+// such that all the entries for a single destination are contiguous in memory.
+// The neighbors are kept compact (index 0 up to neighbor count), destination
+// rows are recycled via a free list.
+struct AntRoutingTable::AntRoutingTableImpl {
+
+  using IndexMap = std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash>;
+
+  static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+  static constexpr std::size_t INITIAL_STRIDE = 8;
+
+  // cumulative distribution of the pheromone values of a single destination
+  // raised to the power beta. Used to select a next hop with a single random
+  // draw and a binary search.
+  struct SelectionCache {
+    double m_beta;
+    bool m_valid;
+    std::vector<double> m_cumulative;
+    std::vector<uint32_t> m_neighbors;
+    // credits of the smooth weighted round-robin selection, aligned with
+    // m_neighbors. Kept when the distribution is rebuilt.
+    std::vector<double> m_credit;
+  };
+
+  explicit AntRoutingTableImpl(std::shared_ptr<AnthocnetConfig> config);
+
+  // index lookups, return NONE in case there is no index for the address
+  uint32_t NeighborIndex(Ipv4Address addr) const;
+  uint32_t DestIndex(Ipv4Address addr) const;
+
+  // returns the row for the destination, creates a new row if there is none
+  uint32_t AcquireDest(Ipv4Address addr);
+  // returns the row to the free list, the row must be empty
+  void ReleaseDest(uint32_t dest);
+
+  // least recently used order of the rows, used to evict destinations
+  // when the table is full.
+  void Touch(uint32_t dest);
+  void Link(uint32_t dest);
+  void Unlink(uint32_t dest);
+  // removes all the entries of the least recently used destination
+  void Evict();
+
+  // neighbor (column) management
+  uint32_t AddNeighbor(const Neighbor& nb);
+  void RemoveNeighbor(uint32_t nb);
+
+  // entry management
+  std::size_t Cell(uint32_t dest, uint32_t nb) const;
+  bool Has(uint32_t dest, uint32_t nb) const;
+  PheromoneEntry Entry(uint32_t dest, uint32_t nb) const;
+  void Store(uint32_t dest, uint32_t nb, const PheromoneEntry& entry);
+  void Erase(uint32_t dest, uint32_t nb);
+  // copies the entry (or its absence) from one column to the other
+  void MoveCell(uint32_t dest, uint32_t fromNb, uint32_t toNb);
+
+  std::size_t RowCount() const;
+  std::size_t NeighborCount() const;
+
+  // increases the capacity of the rows to hold (at least) the given
+  // number of neighbors. Re-lays the complete matrix.
+  void Reserve(std::size_t neighborCount);
+
+  // returns the (rebuilt if needed) selection cache of the row for beta.
+  SelectionCache& Selection(uint32_t dest, double beta);
+  // smooth weighted round-robin: every entry earns its weight in credit, the
+  // entry with the most credit is selected and pays the total weight.
+  std::size_t SmoothSelect(SelectionCache& cache);
+  // marks all the cached distributions of the row as stale.
+  void Invalidate(uint32_t dest);
+
+  // keeps the best and second best neighbor of the row up to date after
+  // the entry of nb changed from oldValue (if it was present).
+  void Rank(uint32_t dest, uint32_t nb, bool wasPresent, double oldValue);
+  // recomputes the best and second best neighbor of the row from scratch.
+  void Rerank(uint32_t dest);
+
+  // evaporation. The stored values are decayed lazily: the value of an entry
+  // at time t is m_values * exp(-rate * (t - m_lastUpdate)). Since all the
+  // entries decay at the same rate, the ratios between them (and hence the
+  // selection distributions and the best neighbors) don't change over time.
+  double Decay(std::size_t cell) const;
+  double Value(std::size_t cell) const;
+  // time at which the entry drops below the evaporation threshold
+  Time Expiry(std::size_t cell) const;
+  // reclaims the evaporated entries of the row, returns true in case the
+  // row was released.
+  bool Expire(uint32_t dest);
+  // reclaims the evaporated entries of all the rows
+  void ExpireAll();
+  // returns the row for the destination after reclaiming its evaporated
+  // entries, NONE in case there is no (more) such row.
+  uint32_t LiveDestIndex(Ipv4Address addr);
+
+  // raises the pheromone value to the power beta, avoids pow for
+  // integer betas.
+  static double Power(double value, double beta);
+  // recomputes the powered columns in case the ant or packet beta changed
+  // since they were last computed.
+  void UpdatePowers();
+  // returns the powered column for beta, nullptr in case there is none
+  const std::vector<double>* PoweredColumn(double beta) const;
+
+  // configuration of the table, shared with the router
+  std::shared_ptr<AnthocnetConfig> m_config;
+
+  // neighbor indices
+  IndexMap m_neighborIndex;
+  std::vector<Neighbor> m_neighbors;
+
+  // destination indices
+  IndexMap m_destIndex;
+  std::vector<Ipv4Address> m_destinations;
+  // the neighbors having an entry in each row, such that queries for a
+  // single destination only touch the neighbors that are relevant.
+  std::vector<std::vector<uint32_t>> m_rowEntries;
+  // the neighbors with the highest and second highest pheromone value in
+  // each row, NONE if there is no such neighbor.
+  std::vector<uint32_t> m_best;
+  std::vector<uint32_t> m_second;
+  std::vector<uint32_t> m_freeRows;
+  // doubly linked list over the rows in use, most recently used first
+  std::vector<uint32_t> m_lruPrev;
+  std::vector<uint32_t> m_lruNext;
+  uint32_t m_lruHead;
+  uint32_t m_lruTail;
+
+  // route lookup statistics
+  uint64_t m_hits;
+  uint64_t m_misses;
+  uint64_t m_evictions;
+
+  // capacity of a single row
+  std::size_t m_stride;
+
+  // the pheromone matrix, indexed via Cell(dest, neighbor)
+  std::vector<double>   m_values;
+  std::vector<uint32_t> m_hopCounts;
+  std::vector<Time>     m_timeEstimates;
+  std::vector<uint8_t>  m_present;
+  std::vector<Time>     m_lastUpdate;
+
+  // earliest time at which an entry of the row (or any row) evaporates
+  std::vector<Time> m_rowExpiry;
+  Time m_nextExpiry;
+
+  // the pheromone values raised to the ant and packet beta, kept in sync
+  // with m_values such that lookups don't have to call pow.
+  double m_antBeta;
+  double m_packetBeta;
+  std::vector<double>   m_antPowered;
+  std::vector<double>   m_packetPowered;
+
+  // cached selection distributions of each row, one per beta in use
+  std::vector<std::vector<SelectionCache>> m_selection;
+  // scratch buffer used while building the selection distributions
+  std::vector<double> m_scratch;
+};
+
+AntRoutingTable::AntRoutingTableImpl::AntRoutingTableImpl(std::shared_ptr<AnthocnetConfig> config)
+  : m_config(config),
+    m_lruHead(NONE), m_lruTail(NONE),
+    m_hits(0), m_misses(0), m_evictions(0),
+    m_stride(INITIAL_STRIDE),
+    m_nextExpiry(Time::Max()),
+    m_antBeta(m_config->antBeta),
+    m_packetBeta(m_config->packetBeta) { }
+
+uint32_t
+AntRoutingTable::AntRoutingTableImpl::NeighborIndex(Ipv4Address addr) const {
+  auto it = m_neighborIndex.find(addr);
+  return it != m_neighborIndex.end() ? it->second : NONE;
+}
+
+uint32_t
+AntRoutingTable::AntRoutingTableImpl::DestIndex(Ipv4Address addr) const {
+  auto it = m_destIndex.find(addr);
+  return it != m_destIndex.end() ? it->second : NONE;
+}
+
+uint32_t
+AntRoutingTable::AntRoutingTableImpl::AcquireDest(Ipv4Address addr) {
+  auto dest = DestIndex(addr);
+  if(dest != NONE) {
+    return dest;
+  }
+
+  // reclaim evaporated rows before growing the table
+  auto maxDestinations = m_config->maxDestinations;
+  bool full = maxDestinations != 0 && m_destIndex.size() >= maxDestinations;
+  if((full || m_freeRows.empty()) && Simulator::Now() >= m_nextExpiry) {
+    ExpireAll();
+  }
+
+  // make room by evicting the least recently used destinations
+  while(maxDestinations != 0 && m_destIndex.size() >= maxDestinations) {
+    Evict();
+  }
+
+  if(!m_freeRows.empty()) {
+    dest = m_freeRows.back();
+    m_freeRows.pop_back();
+    m_destinations[dest] = addr;
+  } else {
+    dest = m_destinations.size();
+    m_destinations.push_back(addr);
+    m_rowEntries.emplace_back();
+    m_best.push_back(NONE);
+    m_second.push_back(NONE);
+    m_lruPrev.push_back(NONE);
+    m_lruNext.push_back(NONE);
+    auto cells = m_destinations.size() * m_stride;
+    m_values.resize(cells, 0);
+    m_antPowered.resize(cells, 0);
+    m_packetPowered.resize(cells, 0);
+    m_hopCounts.resize(cells, 0);
+    m_timeEstimates.resize(cells, Seconds(0));
+    m_present.resize(cells, 0);
+    m_lastUpdate.resize(cells, Seconds(0));
+    m_rowExpiry.push_back(Time::Max());
+    m_selection.emplace_back();
+  }
+
+  m_destIndex[addr] = dest;
+  Link(dest);
+  return dest;
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::ReleaseDest(uint32_t dest) {
+  NS_ASSERT(m_rowEntries[dest].empty());
+  m_destIndex.erase(m_destinations[dest]);
+  m_destinations[dest] = Ipv4Address();
+  m_selection[dest].clear();
+  m_best[dest] = NONE;
+  m_second[dest] = NONE;
+  m_rowExpiry[dest] = Time::Max();
+  Unlink(dest);
+  m_freeRows.push_back(dest);
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::Touch(uint32_t dest) {
+  if(dest != m_lruHead) {
+    Unlink(dest);
+    Link(dest);
+  }
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::Link(uint32_t dest) {
+  m_lruPrev[dest] = NONE;
+  m_lruNext[dest] = m_lruHead;
+  if(m_lruHead != NONE) {
+    m_lruPrev[m_lruHead] = dest;
+  }
+  m_lruHead = dest;
+  if(m_lruTail == NONE) {
+    m_lruTail = dest;
+  }
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::Unlink(uint32_t dest) {
+  auto prev = m_lruPrev[dest];
+  auto next = m_lruNext[dest];
+  (prev != NONE ? m_lruNext[prev] : m_lruHead) = next;
+  (next != NONE ? m_lruPrev[next] : m_lruTail) = prev;
+  m_lruPrev[dest] = NONE;
+  m_lruNext[dest] = NONE;
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::Evict() {
+  NS_ASSERT(m_lruTail != NONE);
+  auto dest = m_lruTail;
+  NS_LOG_DEBUG("Evicting destination " << m_destinations[dest]);
+
+  // erasing the last entry releases the row (and its caches)
+  auto entries = m_rowEntries[dest];
+  for(auto nb : entries) {
+    Erase(dest, nb);
+  }
+  m_evictions++;
+}
+
+uint32_t
+AntRoutingTable::AntRoutingTableImpl::AddNeighbor(const Neighbor& nb) {
+  auto index = NeighborIndex(nb.Address());
+
+  // re-adding a neighbor resets its pheromone entries
+  if(index != NONE) {
+    for(uint32_t dest = 0; dest < RowCount(); dest++) {
+      if(Has(dest, index)) {
+        Erase(dest, index);
+      }
+    }
+    return index;
+  }
+
+  index = m_neighbors.size();
+  Reserve(index + 1);
+  m_neighbors.push_back(nb);
+  m_neighborIndex[nb.Address()] = index;
+  return index;
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::RemoveNeighbor(uint32_t nb) {
+  // keep the neighbors compact: the last neighbor takes the place of the
+  // removed one.
+  uint32_t last = m_neighbors.size() - 1;
+
+  for(uint32_t dest = 0; dest < RowCount(); dest++) {
+    if(Has(dest, nb)) {
+      Erase(dest, nb);
+    }
+    if(nb != last) {
+      MoveCell(dest, last, nb);
+    }
+  }
+
+  m_neighborIndex.erase(m_neighbors[nb].Address());
+  if(nb != last) {
+    m_neighbors[nb] = m_neighbors[last];
+    m_neighborIndex[m_neighbors[nb].Address()] = nb;
+  }
+  m_neighbors.pop_back();
+}
+
+std::size_t
+AntRoutingTable::AntRoutingTableImpl::Cell(uint32_t dest, uint32_t nb) const {
+  return dest * m_stride + nb;
+}
+
+bool
+AntRoutingTable::AntRoutingTableImpl::Has(uint32_t dest, uint32_t nb) const {
+  return m_present[Cell(dest, nb)] != 0;
+}
+
+PheromoneEntry
+AntRoutingTable::AntRoutingTableImpl::Entry(uint32_t dest, uint32_t nb) const {
+  auto cell = Cell(dest, nb);
+  return PheromoneEntry(Value(cell), m_hopCounts[cell], m_timeEstimates[cell]);
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::Store(uint32_t dest, uint32_t nb, const PheromoneEntry& entry) {
+  auto cell = Cell(dest, nb);
+  bool wasPresent = m_present[cell];
+  double oldValue = wasPresent ? Value(cell) : 0;
+  if(!wasPresent) {
+    m_present[cell] = 1;
+    m_rowEntries[dest].push_back(nb);
+  }
+  m_values[cell] = entry.Value();
+  m_antPowered[cell] = Power(entry.Value(), m_antBeta);
+  m_packetPowered[cell] = Power(entry.Value(), m_packetBeta);
+  m_hopCounts[cell] = entry.HopCount();
+  m_timeEstimates[cell] = entry.TimeEstimate();
+  m_lastUpdate[cell] = Simulator::Now();
+
+  auto expiry = Expiry(cell);
+  m_rowExpiry[dest] = std::min(m_rowExpiry[dest], expiry);
+  m_nextExpiry = std::min(m_nextExpiry, expiry);
+
+  Rank(dest, nb, wasPresent, oldValue);
+  Invalidate(dest);
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::Erase(uint32_t dest, uint32_t nb) {
+  auto cell = Cell(dest, nb);
+  if(!m_present[cell]) {
+    return;
+  }
+  m_present[cell] = 0;
+  m_values[cell] = 0;
+  m_antPowered[cell] = 0;
+  m_packetPowered[cell] = 0;
+  m_hopCounts[cell] = 0;
+  m_timeEstimates[cell] = Seconds(0);
+  m_lastUpdate[cell] = Seconds(0);
+  Invalidate(dest);
+
+  auto& entries = m_rowEntries[dest];
+  auto it = std::find(entries.begin(), entries.end(), nb);
+  *it = entries.back();
+  entries.pop_back();
+  if(entries.empty()) {
+    ReleaseDest(dest);
+  } else if(nb == m_best[dest] || nb == m_second[dest]) {
+    Rerank(dest);
+  }
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::MoveCell(uint32_t dest, uint32_t fromNb, uint32_t toNb) {
+  auto from = Cell(dest, fromNb);
+  auto to = Cell(dest, toNb);
+  if(!m_present[from] && !m_present[to]) {
+    return;
+  }
+
+  auto& entries = m_rowEntries[dest];
+  std::replace(entries.begin(), entries.end(), fromNb, toNb);
+  if(m_best[dest] == fromNb) {
+    m_best[dest] = toNb;
+  }
+  if(m_second[dest] == fromNb) {
+    m_second[dest] = toNb;
+  }
+
+  m_present[to] = m_present[from];
+  m_values[to] = m_values[from];
+  m_antPowered[to] = m_antPowered[from];
+  m_packetPowered[to] = m_packetPowered[from];
+  m_hopCounts[to] = m_hopCounts[from];
+  m_timeEstimates[to] = m_timeEstimates[from];
+  m_lastUpdate[to] = m_lastUpdate[from];
+
+  m_present[from] = 0;
+  m_values[from] = 0;
+  m_antPowered[from] = 0;
+  m_packetPowered[from] = 0;
+  m_hopCounts[from] = 0;
+  m_timeEstimates[from] = Seconds(0);
+  m_lastUpdate[from] = Seconds(0);
+  // the cached distributions refer to the neighbor indices
+  Invalidate(dest);
+}
+
+std::size_t
+AntRoutingTable::AntRoutingTableImpl::RowCount() const {
+  return m_destinations.size();
+}
+
+std::size_t
+AntRoutingTable::AntRoutingTableImpl::NeighborCount() const {
+  return m_neighbors.size();
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::Reserve(std::size_t neighborCount) {
+  if(neighborCount <= m_stride) {
+    return;
+  }
+
+  auto stride = m_stride;
+  while(stride < neighborCount) {
+    stride *= 2;
+  }
+
+  auto cells = RowCount() * stride;
+  std::vector<double>   values(cells, 0);
+  std::vector<double>   antPowered(cells, 0);
+  std::vector<double>   packetPowered(cells, 0);
+  std::vector<uint32_t> hopCounts(cells, 0);
+  std::vector<Time>     timeEstimates(cells, Seconds(0));
+  std::vector<uint8_t>  present(cells, 0);
+  std::vector<Time>     lastUpdate(cells, Seconds(0));
+
+  for(uint32_t dest = 0; dest < RowCount(); dest++) {
+    for(uint32_t nb = 0; nb < NeighborCount(); nb++) {
+      auto from = Cell(dest, nb);
+      auto to = dest * stride + nb;
+      values[to] = m_values[from];
+      antPowered[to] = m_antPowered[from];
+      packetPowered[to] = m_packetPowered[from];
+      hopCounts[to] = m_hopCounts[from];
+      timeEstimates[to] = m_timeEstimates[from];
+      present[to] = m_present[from];
+      lastUpdate[to] = m_lastUpdate[from];
+    }
+  }
+
+  m_stride = stride;
+  m_values = std::move(values);
+  m_antPowered = std::move(antPowered);
+  m_packetPowered = std::move(packetPowered);
+  m_hopCounts = std::move(hopCounts);
+  m_timeEstimates = std::move(timeEstimates);
+  m_present = std::move(present);
+  m_lastUpdate = std::move(lastUpdate);
+}
+
+AntRoutingTable::AntRoutingTableImpl::SelectionCache&
+AntRoutingTable::AntRoutingTableImpl::Selection(uint32_t dest, double beta) {
+  auto& caches = m_selection[dest];
+  auto cache = std::find_if(caches.begin(), caches.end(),
+    [beta](const SelectionCache& c) { return c.m_beta == beta; });
+
+  if(cache == caches.end()) {
+    caches.push_back(SelectionCache{beta, false, {}, {}, {}});
+    cache = caches.end() - 1;
+  }
+
+  if(cache->m_valid) {
+    return *cache;
+  }
+
+  UpdatePowers();
+  auto powered = PoweredColumn(beta);
+  bool decay = m_config->evaporationRate > 0;
+
+  // gather the row, such that the kernels work on contiguous memory
+  auto& entries = m_rowEntries[dest];
+  auto count = entries.size();
+  auto row = Cell(dest, 0);
+
+  // carry the round-robin credits over to the new order of the entries
+  std::vector<double> credit(count, 0);
+  for(std::size_t i = 0; i < cache->m_neighbors.size(); i++) {
+    auto it = std::find(entries.begin(), entries.end(), cache->m_neighbors[i]);
+    if(it != entries.end()) {
+      credit[it - entries.begin()] = cache->m_credit[i];
+    }
+  }
+  cache->m_credit = std::move(credit);
+
+  cache->m_neighbors.assign(entries.begin(), entries.end());
+  cache->m_cumulative.resize(count);
+  auto values = cache->m_cumulative.data();
+  for(std::size_t i = 0; i < count; i++) {
+    values[i] = powered ? (*powered)[row + entries[i]] : m_values[row + entries[i]];
+  }
+  if(!powered) {
+    kernel::Power(values, values, count, beta);
+  }
+
+  if(decay) {
+    // all the entries are brought to the current time, later on they keep
+    // decaying by the same factor.
+    m_scratch.resize(count);
+    for(std::size_t i = 0; i < count; i++) {
+      m_scratch[i] = Decay(row + entries[i]);
+    }
+    kernel::Power(m_scratch.data(), m_scratch.data(), count, beta);
+    for(std::size_t i = 0; i < count; i++) {
+      values[i] *= m_scratch[i];
+    }
+  }
+
+  kernel::InclusiveScan(values, values, count);
+  cache->m_valid = true;
+
+  return *cache;
+}
+
+std::size_t
+AntRoutingTable::AntRoutingTableImpl::SmoothSelect(SelectionCache& cache) {
+  auto& cumulative = cache.m_cumulative;
+  std::size_t best = 0;
+  double previous = 0;
+  for(std::size_t i = 0; i < cumulative.size(); i++) {
+    cache.m_credit[i] += cumulative[i] - previous;
+    previous = cumulative[i];
+    if(cache.m_credit[i] > cache.m_credit[best]) {
+      best = i;
+    }
+  }
+
+  cache.m_credit[best] -= cumulative.back();
+  return best;
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::Invalidate(uint32_t dest) {
+  for(auto& cache : m_selection[dest]) {
+    cache.m_valid = false;
+  }
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::Rank(uint32_t dest, uint32_t nb, bool wasPresent, double oldValue) {
+  auto row = Cell(dest, 0);
+  double value = Value(row + nb);
+  auto& best = m_best[dest];
+  auto& second = m_second[dest];
+
+  // a decreasing best or second best entry may be overtaken by any other
+  // entry of the row.
+  if(wasPresent && value < oldValue && (nb == best || nb == second)) {
+    Rerank(dest);
+    return;
+  }
+
+  if(nb == best) {
+    return;
+  }
+
+  if(best == NONE || value > Value(row + best)) {
+    second = best;
+    best = nb;
+  } else if(nb != second && (second == NONE || value > Value(row + second))) {
+    second = nb;
+  }
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::Rerank(uint32_t dest) {
+  auto row = Cell(dest, 0);
+  auto& best = m_best[dest];
+  auto& second = m_second[dest];
+  best = NONE;
+  second = NONE;
+
+  for(auto nb : m_rowEntries[dest]) {
+    if(best == NONE || Value(row + nb) > Value(row + best)) {
+      second = best;
+      best = nb;
+    } else if(second == NONE || Value(row + nb) > Value(row + second)) {
+      second = nb;
+    }
+  }
+}
+
+double
+AntRoutingTable::AntRoutingTableImpl::Decay(std::size_t cell) const {
+  if(m_config->evaporationRate <= 0) {
+    return 1;
+  }
+
+  auto elapsed = (Simulator::Now() - m_lastUpdate[cell]).GetSeconds();
+  return exp(-m_config->evaporationRate * elapsed);
+}
+
+double
+AntRoutingTable::AntRoutingTableImpl::Value(std::size_t cell) const {
+  return m_values[cell] * Decay(cell);
+}
+
+Time
+AntRoutingTable::AntRoutingTableImpl::Expiry(std::size_t cell) const {
+  auto rate = m_config->evaporationRate;
+  auto threshold = m_config->evaporationThreshold;
+  if(rate <= 0) {
+    return Time::Max();
+  }
+
+  if(m_values[cell] <= threshold) {
+    return m_lastUpdate[cell];
+  }
+
+  return m_lastUpdate[cell] + Seconds(log(m_values[cell] / threshold) / rate);
+}
+
+bool
+AntRoutingTable::AntRoutingTableImpl::Expire(uint32_t dest) {
+  if(Simulator::Now() < m_rowExpiry[dest]) {
+    return false;
+  }
+
+  // erasing the last entry releases the row, so copy the entries first
+  auto row = Cell(dest, 0);
+  auto entries = m_rowEntries[dest];
+  auto expiry = Time::Max();
+  for(auto nb : entries) {
+    auto cellExpiry = Expiry(row + nb);
+    if(cellExpiry <= Simulator::Now()) {
+      Erase(dest, nb);
+    } else {
+      expiry = std::min(expiry, cellExpiry);
+    }
+  }
+
+  if(m_rowEntries[dest].empty()) {
+    return true;
+  }
+
+  m_rowExpiry[dest] = expiry;
+  return false;
+}
+
+void
+AntRoutingTable::AntRoutingTableImpl::ExpireAll() {
+  m_nextExpiry = Time::Max();
+  for(uint32_t dest = 0; dest < RowCount(); dest++) {
+    if(!m_rowEntries[dest].empty() && !Expire(dest)) {
+      m_nextExpiry = std::min(m_nextExpiry, m_rowExpiry[dest]);
+    }
+  }
+}
+
+uint32_t
+AntRoutingTable::AntRoutingTableImpl::LiveDestIndex(Ipv4Address addr) {
+  auto dest = DestIndex(addr);
+  if(dest == NONE || Expire(dest)) {
+    return NONE;
+  }
+
+  return dest;
+}
+
+double
+AntRoutingTable::AntRoutingTableImpl::Power(double value, double beta) {
+  // small integer exponents (the default betas) are done by multiplication
+  if(beta >= 0 && beta <= 8 && beta == std::floor(beta)) {
+    double result = 1;
+    for(uint32_t i = 0; i < static_cast<uint32_t>(beta); i++) {
+      result *= value;
+    }
+    return result;
+  }
+
+  return kernel::FastPow(value, beta);
+}
 
+void
+AntRoutingTable::AntRoutingTableImpl::UpdatePowers() {
+  if(m_antBeta == m_config->antBeta && m_packetBeta == m_config->packetBeta) {
+    return;
+  }
+
+  m_antBeta = m_config->antBeta;
+  m_packetBeta = m_config->packetBeta;
+  for(std::size_t cell = 0; cell < m_values.size(); cell++) {
+    if(m_present[cell]) {
+      m_antPowered[cell] = Power(m_values[cell], m_antBeta);
+      m_packetPowered[cell] = Power(m_values[cell], m_packetBeta);
+    }
+  }
+  // the cached distributions are keyed by beta and remain valid
+}
+
+const std::vector<double>*
+AntRoutingTable::AntRoutingTableImpl::PoweredColumn(double beta) const {
+  if(beta == m_antBeta) {
+    return &m_antPowered;
+  }
+
+  if(beta == m_packetBeta) {
+    return &m_packetPowered;
+  }
+
+  return nullptr;
+}
+
+// AntRoutingTable definition --------------------------------------------------
 // implementation of methods
-AntRoutingTable::AntRoutingTable() : m_table(std::make_shared<RoutingTableType>()) { }
+AntRoutingTable::AntRoutingTable() : AntRoutingTable(AnthocnetConfig::Defaults()) { }
+
+AntRoutingTable::AntRoutingTable(std::shared_ptr<AnthocnetConfig> config)
+  : m_impl(std::make_shared<AntRoutingTableImpl>(config)) { }
 
 // methods related to generating routes
 Ptr<Ipv4Route>
 AntRoutingTable::RouteTo(const Ipv4Header& ipv4h) {
-  return RouteTo(ipv4h.GetSource(), ipv4h.GetDestination(), PacketBeta());
+  auto& config = *m_impl->m_config;
+  return RouteTo(ipv4h.GetSource(), ipv4h.GetDestination(), config.packetBeta,
+                 config.packetSelection == PacketSelection::WeightedRoundRobin);
 }
 
 Ptr<Ipv4Route>
 AntRoutingTable::RouteTo(const AntHeader& ah){
-  return RouteTo(ah.GetSource(), ah.GetDestination(), AntBeta());
+  return RouteTo(ah.GetSource(), ah.GetDestination(), m_impl->m_config->antBeta);
 }
 
 Ptr<Ipv4Route>
-AntRoutingTable::RouteTo(Ipv4Address source, Ipv4Address dest, double beta) {
-  auto optNeighbor = RouteToNeighbor(source, dest, beta);
-  return optNeighbor.IsValid() ? optNeighbor.Get().CreateRoute(source, dest) : Ptr<Ipv4Route>();
+AntRoutingTable::RouteTo(Ipv4Address source, Ipv4Address dest, double beta, bool smooth) {
+  auto optNeighbor = RouteToNeighbor(source, dest, beta, smooth);
+  return optNeighbor.IsValid() ? optNeighbor.Get().CachedRoute(source, dest) : Ptr<Ipv4Route>();
 }
 
 OptNeighbor
 AntRoutingTable::RoutePacket(const Ipv4Header& header) {
-  return RouteToNeighbor(header.GetSource(), header.GetDestination(), PacketBeta());
+  auto& config = *m_impl->m_config;
+  return RouteToNeighbor(header.GetSource(), header.GetDestination(), config.packetBeta,
+                         config.packetSelection == PacketSelection::WeightedRoundRobin);
 }
 
 OptNeighbor
 AntRoutingTable::RouteAnt(const AntHeader& header) {
-  return RouteToNeighbor(header.GetSource(), header.GetDestination(), AntBeta());
+  return RouteToNeighbor(header.GetSource(), header.GetDestination(), m_impl->m_config->antBeta);
 }
 
 OptNeighbor
-AntRoutingTable::RouteToNeighbor(Ipv4Address source, Ipv4Address dest, double beta) {
+AntRoutingTable::RouteToNeighbor(Ipv4Address source, Ipv4Address dest, double beta, bool smooth) {
 
     // if direct neighbor, no need to evaluate the pheromone table
     auto optNeighbor = GetNeighbor(dest);
@@ -144,30 +888,27 @@ AntRoutingTable::RouteToNeighbor(Ipv4Address source, Ipv4Address dest, double be
       return optNeighbor;
     }
 
-    // case that no entries in the table (no neighbors) return empty pointer
-    if (m_table->empty() || !HasPheromoneEntryFor(dest)) {
+    // case that there are no entries for the destination, return empty optional
+    auto destIndex = m_impl->LiveDestIndex(dest);
+    if (destIndex == AntRoutingTableImpl::NONE) {
+      m_impl->m_misses++;
       return OptNeighbor();
     }
+    m_impl->m_hits++;
+    m_impl->Touch(destIndex);
 
-    double totalPheromone = TotalPheromone(dest, beta);
-    double selectionPoint = GetRand();
-    double accumulator = 0;
-    auto neighbors = Neighbors();
-
-    // loop over all entries except for the last one
-    for(auto neighborIt = neighbors.begin(); neighborIt != --neighbors.end(); neighborIt++) {
-      auto entryPtr = GetPheromone(neighborIt->Address(), dest);
-      if (entryPtr != nullptr) {
-        accumulator += (pow(entryPtr->Value(), beta) / totalPheromone);
-      }
-      if (selectionPoint <= accumulator) {
-        return OptNeighbor(neighborIt->Get());
-      }
+    auto& selection = m_impl->Selection(destIndex, beta);
+    if(smooth) {
+      return OptNeighbor(m_impl->m_neighbors[selection.m_neighbors[m_impl->SmoothSelect(selection)]]);
     }
 
-    // return the last entry in case the loop completed.
-    // This seperate case is needed to deal with rounding errors in the accumulator
-    return OptNeighbor((neighbors.rbegin())->Get());
+    // select the first neighbor whose cumulative pheromone reaches the
+    // selection point.
+    double selectionPoint = GetRand() * selection.m_cumulative.back();
+    // returns the last entry in case no entry was found, this is needed to
+    // deal with rounding errors in the accumulator
+    auto index = kernel::SelectIndex(selection.m_cumulative.data(), selection.m_cumulative.size(), selectionPoint);
+    return OptNeighbor(m_impl->m_neighbors[selection.m_neighbors[index]]);
 }
 
 std::vector<Ptr<Ipv4Route>>
@@ -175,31 +916,21 @@ AntRoutingTable::NoPheromoneRoutes(const AntHeader& ah) {
   Ipv4Address source = ah.GetSource();
   Ipv4Address destination = ah.GetDestination();
   std::vector<Ptr<Ipv4Route>> routes;
-  auto neighbors = Neighbors();
 
-  for(auto neighborIt = neighbors.begin(); neighborIt != neighbors.end(); neighborIt ++) {
-    auto entryPtr = GetPheromone(neighborIt -> Address(), destination);
-    if (entryPtr == nullptr) {
-      auto route = neighborIt->Get().CreateRoute(source, destination);
-      routes.push_back(route);
-    }
-  }
+  ForEachNoPheromoneNeighbor(destination, [&] (const Neighbor& neighbor) {
+    routes.push_back(neighbor.CachedRoute(source, destination));
+  });
 
   return routes;
 }
 
 std::vector<Neighbor>
 AntRoutingTable::NoPheromoneNeighbors(const AntHeader& header) {
-  Ipv4Address dest   = header.GetDestination();
   std::vector<Neighbor> neighbors;
 
-  for(auto neighborTableIt = m_table -> begin(); neighborTableIt != m_table -> end(); neighborTableIt++) {
-    auto entryPtr = GetPheromone(neighborTableIt -> first.Address(), dest);
-    if(entryPtr == nullptr) {
-      auto neighbor = neighborTableIt -> first.Get();
-      neighbors.push_back(neighbor);
-    }
-  }
+  ForEachNoPheromoneNeighbor(header.GetDestination(), [&neighbors] (const Neighbor& neighbor) {
+    neighbors.push_back(neighbor);
+  });
 
   return neighbors;
 }
@@ -209,24 +940,28 @@ AntRoutingTable::BroadcastRouteTo(const AntHeader& ah) {
   Ipv4Address source = ah.GetSource();
   Ipv4Address destination = ah.GetDestination();
   std::vector<Ptr<Ipv4Route>> routes;
-  auto neighbors = Neighbors();
+  routes.reserve(NeighborCount());
 
-  for(auto neighborIt = neighbors.begin(); neighborIt != neighbors.end(); neighborIt++) {
-    auto route = neighborIt->Get().CreateRoute(source, destination);
-    routes.push_back(route);
-  }
+  ForEachNeighbor([&] (const Neighbor& neighbor) {
+    routes.push_back(neighbor.CachedRoute(source, destination));
+  });
 
   return routes;
 }
 
-std::vector<Neighbor>
-AntRoutingTable::BroadcastNeighbors() {
-  std::vector<Neighbor> neighbors;
-  for(auto neighborTableIt = m_table -> begin(); neighborTableIt != m_table->end(); neighborTableIt ++){
-    neighbors.push_back(neighborTableIt->first.Get());
+const uint8_t*
+AntRoutingTable::PheromoneRow(Ipv4Address destination) {
+  auto destIndex = m_impl->LiveDestIndex(destination);
+  if(destIndex == AntRoutingTableImpl::NONE) {
+    return nullptr;
   }
 
-  return neighbors;
+  return m_impl->m_present.data() + m_impl->Cell(destIndex, 0);
+}
+
+std::vector<Neighbor>
+AntRoutingTable::BroadcastNeighbors() {
+  return m_impl->m_neighbors;
 }
 
 
@@ -234,99 +969,99 @@ AntRoutingTable::BroadcastNeighbors() {
 // methods related to pheromone management
 void
 AntRoutingTable::UpdatePheromoneEntry(Ipv4Address neighbor, Ipv4Address dest, Time timeEstimate,  uint32_t hops) {
-  auto neighborTablePtr = GetNeighborTable(NeighborKey(neighbor));
-  if (neighborTablePtr == nullptr) {
+  auto nbIndex = m_impl->NeighborIndex(neighbor);
+  if (nbIndex == AntRoutingTableImpl::NONE) {
     NS_LOG_WARN("Tried to update a next hop pheromone entry of a node that is not a neighbor.");
     return;
   }
   // create a new pheromone entry in case there isn't one yet
-  if(!HasPheromoneEntryFor(neighbor, dest)) {
-    neighborTablePtr->operator[](dest) = std::make_shared<PheromoneEntry>();
-  }
-  // update the entry in the map
-  std::shared_ptr<PheromoneEntry> pheromoneEntryPtr = neighborTablePtr->operator[](dest);
-  double extraPheromone = 1/(s_rho*timeEstimate.GetSeconds() + (1-s_rho)*hops*HopTime().GetSeconds());
-  pheromoneEntryPtr->Value(s_gamma * pheromoneEntryPtr->Value() + (1 - s_gamma)*extraPheromone);
-  pheromoneEntryPtr->HopCount(s_bestEstCoeff * pheromoneEntryPtr ->HopCount() + (1-s_bestEstCoeff)*hops);
-  auto timeUpdate = Seconds(s_bestEstCoeff* pheromoneEntryPtr->TimeEstimate().GetSeconds() + (1-s_bestEstCoeff)*timeEstimate.GetSeconds());
+  auto destIndex = m_impl->AcquireDest(dest);
+  PheromoneEntry entry = m_impl->Has(destIndex, nbIndex) ? m_impl->Entry(destIndex, nbIndex) : PheromoneEntry();
+
+  // update the entry in the matrix
+  auto& config = *m_impl->m_config;
+  double extraPheromone = 1/(config.rho*timeEstimate.GetSeconds() + (1-config.rho)*hops*config.hopTime.GetSeconds());
+  entry.Value(config.gamma * entry.Value() + (1 - config.gamma)*extraPheromone);
+  entry.HopCount(config.bestEstCoeff * entry.HopCount() + (1-config.bestEstCoeff)*hops);
+  auto timeUpdate = Seconds(config.bestEstCoeff* entry.TimeEstimate().GetSeconds() + (1-config.bestEstCoeff)*timeEstimate.GetSeconds());
   NS_LOG_UNCOND("Time updated by the backward ant: " << timeUpdate);
-  pheromoneEntryPtr->TimeEstimate(timeUpdate);
+  entry.TimeEstimate(timeUpdate);
+  m_impl->Store(destIndex, nbIndex, entry);
 }
 
 bool
 AntRoutingTable::HasPheromoneEntryFor(Ipv4Address destination) {
-  auto neighbors = Neighbors();
-
-  for(auto neighborIt = neighbors.begin(); neighborIt != neighbors.end(); neighborIt++) {
-    auto entryPtr = GetPheromone(neighborIt -> Address(), destination);
-
-    if(entryPtr != nullptr) {
-      return true;
-    }
-  }
-
-  return false;
+  // rows only exist as long as they contain at least one entry
+  return m_impl->LiveDestIndex(destination) != AntRoutingTableImpl::NONE;
 }
 
 bool
-AntRoutingTable::HasPheromoneEntryFor(Ipv4Address source, Ipv4Address destination) {
-  return GetPheromone(source, destination) != nullptr;
+AntRoutingTable::HasPheromoneEntryFor(Ipv4Address neighbor, Ipv4Address destination) {
+  auto nbIndex = m_impl->NeighborIndex(neighbor);
+  auto destIndex = m_impl->LiveDestIndex(destination);
+  return nbIndex != AntRoutingTableImpl::NONE
+      && destIndex != AntRoutingTableImpl::NONE
+      && m_impl->Has(destIndex, nbIndex);
 }
 
 void
 AntRoutingTable::DeletePheromoneEntryFor(Ipv4Address neighbor, Ipv4Address destination) {
-  auto neighborTable = GetNeighborTable(neighbor);
-  neighborTable -> erase(destination);
+  if(!HasPheromoneEntryFor(neighbor, destination)) {
+    return;
+  }
+
+  m_impl->Erase(m_impl->DestIndex(destination), m_impl->NeighborIndex(neighbor));
 }
 
 const std::shared_ptr<PheromoneEntry>
 AntRoutingTable::GetPheromone(Ipv4Address neighbor, Ipv4Address destination) {
-  auto neighborTableIt = m_table->find(neighbor);
-
-  if (neighborTableIt == m_table->end()) {
+  if(!HasPheromoneEntryFor(neighbor, destination)) {
     return nullptr;
   }
 
-  std::shared_ptr<NeighborTable> neighborTable = neighborTableIt->second;
-  auto pheromoneEntryIt = neighborTable->find(destination);
-
-  if(pheromoneEntryIt == neighborTable->end()) {
-    return nullptr;
-  }
-
-  return pheromoneEntryIt->second;
-
+  auto entry = m_impl->Entry(m_impl->DestIndex(destination), m_impl->NeighborIndex(neighbor));
+  return std::make_shared<PheromoneEntry>(entry);
 }
 
 void
 AntRoutingTable::SetPheromoneAt(Ipv4Address neighbor, Ipv4Address destination, const PheromoneEntry& entry) {
-  // the neighbor table must exist, otherwise we silently ignore the call
-  auto neighborTableIt = m_table->find(neighbor);
-
-  if (neighborTableIt == m_table->end()) {
+  // the neighbor must exist, otherwise we silently ignore the call
+  auto nbIndex = m_impl->NeighborIndex(neighbor);
+  if (nbIndex == AntRoutingTableImpl::NONE) {
     return;
   }
 
   // change the entry for the destination or create a new one for the
   // given destination in case there wasn't any.
-  std::shared_ptr<NeighborTable> neighborTable = neighborTableIt->second;
-  (*neighborTable)[destination] = std::make_shared<PheromoneEntry>(entry);
+  m_impl->Store(m_impl->AcquireDest(destination), nbIndex, entry);
+}
+
+double
+AntRoutingTable::PheromoneValue(Ipv4Address neighbor, Ipv4Address destination) {
+  if(!HasPheromoneEntryFor(neighbor, destination)) {
+    return 0;
+  }
+
+  return m_impl->Value(m_impl->Cell(m_impl->DestIndex(destination), m_impl->NeighborIndex(neighbor)));
+}
+
+double
+AntRoutingTable::BestPheromoneValue(Ipv4Address destination) {
+  auto destIndex = m_impl->LiveDestIndex(destination);
+  if(destIndex == AntRoutingTableImpl::NONE) {
+    return 0;
+  }
+
+  return m_impl->Value(m_impl->Cell(destIndex, m_impl->m_best[destIndex]));
 }
 
 double AntRoutingTable::TotalPheromone(Ipv4Address dest, double beta) {
-  double totalPheromone = 0;
-
-  for(auto nbrTableIt = m_table->begin(); nbrTableIt != m_table->end(); nbrTableIt++) {
-    std::shared_ptr<NeighborTable> nbrTablePtr = nbrTableIt -> second;
-    auto pheromoneIt = nbrTablePtr->find(dest);
-    // if there is an entry for the destination, add the value
-    if (pheromoneIt != nbrTablePtr->end()) {
-      std::shared_ptr<PheromoneEntry> entry = pheromoneIt->second;
-      totalPheromone += pow(entry->Value(), beta);
-    }
+  auto destIndex = m_impl->LiveDestIndex(dest);
+  if(destIndex == AntRoutingTableImpl::NONE) {
+    return 0;
   }
 
-  return totalPheromone;
+  return m_impl->Selection(destIndex, beta).m_cumulative.back();
 }
 
 
@@ -334,22 +1069,25 @@ double AntRoutingTable::TotalPheromone(Ipv4Address dest, double beta) {
 
 void
 AntRoutingTable::AddNeighbor(const Neighbor& nb) {
-  (*m_table)[NeighborKey(nb)] = std::make_shared<NeighborTable>();
+  m_impl->AddNeighbor(nb);
 }
 void
 AntRoutingTable::RemoveNeighbor(const Neighbor& nb) {
-  m_table->erase(nb);
+  auto nbIndex = m_impl->NeighborIndex(nb.Address());
+  if(nbIndex != AntRoutingTableImpl::NONE) {
+    m_impl->RemoveNeighbor(nbIndex);
+  }
 }
 
 bool
 AntRoutingTable::HasNeighbors() {
-  return !(m_table -> empty());
+  return m_impl->NeighborCount() != 0;
 }
 
 OptNeighbor AntRoutingTable::GetNeighbor(Ipv4Address addr) {
-  auto neighborTableIter = m_table->find(addr);
-  if (neighborTableIter != m_table->end()) {
-    return OptNeighbor(neighborTableIter->first);
+  auto nbIndex = m_impl->NeighborIndex(addr);
+  if (nbIndex != AntRoutingTableImpl::NONE) {
+    return OptNeighbor(m_impl->m_neighbors[nbIndex]);
   }
 
   return OptNeighbor();
@@ -359,15 +1097,18 @@ std::vector<AlternativeRoute>
 AntRoutingTable::BestAlternativesFor(const Neighbor& neighbor) {
 
   std::vector<AlternativeRoute> alternatives;
+  auto nbIndex = m_impl->NeighborIndex(neighbor.Address());
+  if(nbIndex == AntRoutingTableImpl::NONE) {
+    return alternatives;
+  }
 
-  auto neighborTable = GetNeighborTable(neighbor);
-  for(auto destEntryIt = neighborTable->begin(); destEntryIt != neighborTable->end(); destEntryIt++) {
+  for(uint32_t dest = 0; dest < m_impl->RowCount(); dest++) {
 
-    if (!IsBestEntryFor(neighbor, destEntryIt->first)) {
+    if (!m_impl->Has(dest, nbIndex) || !IsBestEntryFor(neighbor, m_impl->m_destinations[dest])) {
       continue;
     }
 
-    auto alt = GetBestAlternativeFor(neighbor, destEntryIt->first);
+    auto alt = GetBestAlternativeFor(neighbor, m_impl->m_destinations[dest]);
     alternatives.push_back(alt);
   }
 
@@ -377,27 +1118,17 @@ AntRoutingTable::BestAlternativesFor(const Neighbor& neighbor) {
 
 bool
 AntRoutingTable::IsBestEntryFor(Ipv4Address neighborAddr, Ipv4Address destination) {
-  auto neighborEntry = GetPheromone(neighborAddr, destination);
-
-  if(neighborEntry == nullptr) {
+  if(!HasPheromoneEntryFor(neighborAddr, destination)) {
     return false;
   }
 
-  auto neighbors = Neighbors();
-  double neighborValue = neighborEntry->Value();
-
-  for(auto neighborIt = neighbors.begin(); neighborIt != neighbors.end(); neighborIt++) {
-
-    if(neighborIt -> Get().Address() == neighborAddr) {
-      continue;
-    }
-
-    auto entry = GetPheromone(neighborIt->Address(), destination);
-    if (entry != nullptr && (entry -> Value()) > neighborValue) {
-      return false;
-    }
-  }
-  return true;
+  // ties with the best entry also count as best. The entries evaporate since
+  // their last update, so the decayed values are compared.
+  auto nbIndex = m_impl->NeighborIndex(neighborAddr);
+  auto destIndex = m_impl->DestIndex(destination);
+  auto best = m_impl->m_best[destIndex];
+  auto row = m_impl->Cell(destIndex, 0);
+  return nbIndex == best || m_impl->Value(row + nbIndex) >= m_impl->Value(row + best);
 }
 
 bool
@@ -407,20 +1138,25 @@ AntRoutingTable::IsBestEntryFor(const Neighbor& neighbor, Ipv4Address destinatio
 
 AlternativeRoute
 AntRoutingTable::GetBestAlternativeFor(Ipv4Address neighborAddr, Ipv4Address destination) {
-  auto neighbors = Neighbors();
-
   AlternativeRoute bestAlt;
   bestAlt.m_destination = destination;
 
-  for(auto neighborIt =  neighbors.begin(); neighborIt != neighbors.end(); neighborIt++) {
-    if(neighborIt -> Get().Address() == neighborAddr) {
-      continue;
-    }
+  auto destIndex = m_impl->LiveDestIndex(destination);
+  if(destIndex == AntRoutingTableImpl::NONE) {
+    return bestAlt;
+  }
 
-    auto entry = GetPheromone(neighborIt->Address(), destination);
-    if (entry != nullptr && (entry -> Value()) > bestAlt.m_pheromone.Value()) {
-      bestAlt = AlternativeRoute(destination, *neighborIt, *entry, true);
-    }
+  // the best alternative is the best entry, or the runner-up in case the
+  // neighbor itself holds the best entry.
+  auto nbIndex = m_impl->NeighborIndex(neighborAddr);
+  auto alt = m_impl->m_best[destIndex] != nbIndex ? m_impl->m_best[destIndex] : m_impl->m_second[destIndex];
+  if(alt == AntRoutingTableImpl::NONE) {
+    return bestAlt;
+  }
+
+  auto entry = m_impl->Entry(destIndex, alt);
+  if (entry.Value() > bestAlt.m_pheromone.Value()) {
+    bestAlt = AlternativeRoute(destination, m_impl->m_neighbors[alt], entry, true);
   }
 
   return bestAlt;
@@ -451,13 +1187,192 @@ AntRoutingTable::GetBestAlternativeFor(const Neighbor& neighbor, Ipv4Address des
   return GetBestAlternativeFor(neighbor.Address(), destination);
 }
 
+uint64_t
+AntRoutingTable::LookupHits() const {
+  return m_impl->m_hits;
+}
+
+uint64_t
+AntRoutingTable::LookupMisses() const {
+  return m_impl->m_misses;
+}
+
+uint64_t
+AntRoutingTable::Evictions() const {
+  return m_impl->m_evictions;
+}
+
+std::size_t
+AntRoutingTable::DestinationCount() const {
+  return m_impl->m_destIndex.size();
+}
+
+// snapshots ------------------------------------------------------------------
+// layout (all integers little endian):
+//   magic "ANTS", version (u32)
+//   neighbor count (u32), neighbor addresses (u32 each)
+//   entry count (u32), entries ordered by destination and neighbor index, of
+//     destination (u32), neighbor index (u32), value (f64),
+//     hop count (u32), time estimate in nanoseconds (i64)
+
+namespace {
+
+const char SNAPSHOT_MAGIC[4] = {'A', 'N', 'T', 'S'};
+const uint32_t SNAPSHOT_VERSION = 1;
+
+void
+WriteU32(std::ostream& os, uint32_t val) {
+  char buf[4];
+  for(int i = 0; i < 4; i++) {
+    buf[i] = static_cast<char>((val >> (8 * i)) & 0xff);
+  }
+  os.write(buf, 4);
+}
+
+void
+WriteU64(std::ostream& os, uint64_t val) {
+  WriteU32(os, static_cast<uint32_t>(val));
+  WriteU32(os, static_cast<uint32_t>(val >> 32));
+}
+
+bool
+ReadU32(std::istream& is, uint32_t& val) {
+  unsigned char buf[4];
+  if(!is.read(reinterpret_cast<char*>(buf), 4)) {
+    return false;
+  }
+  val = 0;
+  for(int i = 0; i < 4; i++) {
+    val |= static_cast<uint32_t>(buf[i]) << (8 * i);
+  }
+  return true;
+}
+
+bool
+ReadU64(std::istream& is, uint64_t& val) {
+  uint32_t low, high;
+  if(!ReadU32(is, low) || !ReadU32(is, high)) {
+    return false;
+  }
+  val = (static_cast<uint64_t>(high) << 32) | low;
+  return true;
+}
+
+uint64_t
+DoubleBits(double val) {
+  uint64_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  return bits;
+}
+
+double
+BitsDouble(uint64_t bits) {
+  double val;
+  std::memcpy(&val, &bits, sizeof(val));
+  return val;
+}
+
+} // namespace
+
+void
+AntRoutingTable::SaveSnapshot(std::ostream& os) {
+  // evaporated entries are not worth saving
+  m_impl->ExpireAll();
+
+  os.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  WriteU32(os, SNAPSHOT_VERSION);
+
+  WriteU32(os, m_impl->NeighborCount());
+  for(auto& neighbor : m_impl->m_neighbors) {
+    WriteU32(os, neighbor.Address().Get());
+  }
+
+  uint32_t entryCount = 0;
+  for(auto& row : m_impl->m_rowEntries) {
+    entryCount += row.size();
+  }
+
+  // the rows and columns are written by index, such that snapshots of the
+  // same table are identical. Released rows hold no entries.
+  WriteU32(os, entryCount);
+  for(uint32_t dest = 0; dest < m_impl->RowCount(); dest++) {
+    if(m_impl->m_rowEntries[dest].empty()) {
+      continue;
+    }
+    for(uint32_t nb = 0; nb < m_impl->NeighborCount(); nb++) {
+      if(!m_impl->Has(dest, nb)) {
+        continue;
+      }
+      auto entry = m_impl->Entry(dest, nb);
+      WriteU32(os, m_impl->m_destinations[dest].Get());
+      WriteU32(os, nb);
+      WriteU64(os, DoubleBits(entry.Value()));
+      WriteU32(os, entry.HopCount());
+      WriteU64(os, static_cast<uint64_t>(entry.TimeEstimate().GetNanoSeconds()));
+    }
+  }
+}
+
+bool
+AntRoutingTable::LoadSnapshot(std::istream& is, std::function<Neighbor(Ipv4Address)> neighborFactory) {
+  char magic[sizeof(SNAPSHOT_MAGIC)];
+  uint32_t version;
+  if(!is.read(magic, sizeof(magic))
+     || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0
+     || !ReadU32(is, version) || version != SNAPSHOT_VERSION) {
+    return false;
+  }
+
+  // the neighbor indices of the snapshot, mapped onto the neighbors of the table
+  uint32_t neighborCount;
+  if(!ReadU32(is, neighborCount)) {
+    return false;
+  }
+
+  std::vector<Ipv4Address> neighbors;
+  for(uint32_t i = 0; i < neighborCount; i++) {
+    uint32_t addr;
+    if(!ReadU32(is, addr)) {
+      return false;
+    }
+
+    Ipv4Address address(addr);
+    if(!IsNeighbor(address)) {
+      auto neighbor = neighborFactory(address);
+      // the factory may already have added the neighbor to the table
+      if(!IsNeighbor(address)) {
+        AddNeighbor(neighbor);
+      }
+    }
+    neighbors.push_back(address);
+  }
+
+  uint32_t entryCount;
+  if(!ReadU32(is, entryCount)) {
+    return false;
+  }
+
+  for(uint32_t i = 0; i < entryCount; i++) {
+    uint32_t dest, nb, hops;
+    uint64_t value, timeEstimate;
+    if(!ReadU32(is, dest) || !ReadU32(is, nb) || !ReadU64(is, value)
+       || !ReadU32(is, hops) || !ReadU64(is, timeEstimate) || nb >= neighbors.size()) {
+      return false;
+    }
+
+    auto entry = PheromoneEntry(BitsDouble(value), hops, NanoSeconds(static_cast<int64_t>(timeEstimate)));
+    SetPheromoneAt(neighbors[nb], Ipv4Address(dest), entry);
+  }
+
+  return true;
+}
+
 bool AntRoutingTable::IsNeighbor(Ipv4Address addr) {
-  return IsNeighbor(NeighborKey(addr));
+  return m_impl->NeighborIndex(addr) != AntRoutingTableImpl::NONE;
 }
 
 bool AntRoutingTable::IsNeighbor(Neighbor neighbor) {
-  auto neighborTableIter = m_table->find(neighbor);
-  return neighborTableIter != m_table->end();
+  return IsNeighbor(neighbor.Address());
 }
 
 
@@ -466,80 +1381,122 @@ bool AntRoutingTable::IsNeighbor(Neighbor neighbor) {
 std::vector<NeighborKey>
 AntRoutingTable::Neighbors() {
   std::vector<NeighborKey> neighbors;
-  for (auto neighborTableIt = m_table->begin(); neighborTableIt != m_table->end(); neighborTableIt ++ ) {
-    neighbors.push_back(neighborTableIt->first);
-  }
+  neighbors.reserve(NeighborCount());
+  ForEachNeighbor([&neighbors] (const Neighbor& neighbor) {
+    neighbors.push_back(NeighborKey(neighbor));
+  });
 
   return neighbors;
 }
 
-std::shared_ptr<AntRoutingTable::NeighborTable> AntRoutingTable::GetNeighborTable(NeighborKey neighbor) {
-  auto neighborTableIt = m_table->find(neighbor);
-  return neighborTableIt != m_table->end() ? neighborTableIt->second : std::make_shared<NeighborTable>();
+NeighborView
+AntRoutingTable::NeighborsView() const {
+  auto& neighbors = m_impl->m_neighbors;
+  return NeighborView(neighbors.data(), neighbors.data() + neighbors.size());
+}
+
+std::size_t
+AntRoutingTable::NeighborCount() const {
+  return m_impl->NeighborCount();
 }
 
 
+// the static accessors operate on the default configuration
 double
 AntRoutingTable::AntBeta() {
-  return s_antBeta;
+  return AnthocnetConfig::Defaults()->antBeta;
 }
 void
 AntRoutingTable::AntBeta(double antBeta){
-  s_antBeta = antBeta;
+  AnthocnetConfig::Defaults()->antBeta = antBeta;
 }
 
 double
 AntRoutingTable::PacketBeta(){
-  return s_packetBeta;
+  return AnthocnetConfig::Defaults()->packetBeta;
 }
 void
 AntRoutingTable::PacketBeta(double packetBeta){
-  s_packetBeta = packetBeta;
+  AnthocnetConfig::Defaults()->packetBeta = packetBeta;
 }
 
 double
 AntRoutingTable::Gamma(){
-  return s_gamma;
+  return AnthocnetConfig::Defaults()->gamma;
 }
 void
 AntRoutingTable::Gamma(double gamma){
   if(0.0 <= gamma && gamma <= 1.0) {
-    s_gamma = gamma;
+    AnthocnetConfig::Defaults()->gamma = gamma;
   }
 }
 
 double
 AntRoutingTable::Rho() {
-  return s_rho;
+  return AnthocnetConfig::Defaults()->rho;
 }
 
 void
 AntRoutingTable::Rho(double rho) {
   if(0.0 <= rho && rho <= 1.0) {
-    s_rho = rho;
+    AnthocnetConfig::Defaults()->rho = rho;
   }
 }
 
 Time
 AntRoutingTable::HopTime(){
-  return s_hopTime;
+  return AnthocnetConfig::Defaults()->hopTime;
 }
 void
 AntRoutingTable::HopTime(Time hopTime){
-  s_hopTime = hopTime;
+  AnthocnetConfig::Defaults()->hopTime = hopTime;
 }
 
 double
 AntRoutingTable::BestEstCoeff() {
-  return s_bestEstCoeff;
+  return AnthocnetConfig::Defaults()->bestEstCoeff;
 }
 void
 AntRoutingTable::BestEstCoeff(double coeff) {
   if(0.0 <= coeff && coeff <= 1.0) {
-    s_bestEstCoeff = coeff;
+    AnthocnetConfig::Defaults()->bestEstCoeff = coeff;
+  }
+}
+
+double
+AntRoutingTable::EvaporationRate() {
+  return AnthocnetConfig::Defaults()->evaporationRate;
+}
+
+void
+AntRoutingTable::EvaporationRate(double rate) {
+  if(0.0 <= rate) {
+    AnthocnetConfig::Defaults()->evaporationRate = rate;
+  }
+}
+
+double
+AntRoutingTable::EvaporationThreshold() {
+  return AnthocnetConfig::Defaults()->evaporationThreshold;
+}
+
+void
+AntRoutingTable::EvaporationThreshold(double threshold) {
+  if(0.0 < threshold) {
+    AnthocnetConfig::Defaults()->evaporationThreshold = threshold;
   }
 }
 
+uint32_t
+AntRoutingTable::MaxDestinations() {
+  return AnthocnetConfig::Defaults()->maxDestinations;
+}
+
+void
+AntRoutingTable::MaxDestinations(uint32_t maxDestinations) {
+  AnthocnetConfig::Defaults()->maxDestinations = maxDestinations;
+}
+
 
 } // namespace ant_routing
 } // namespace ns3
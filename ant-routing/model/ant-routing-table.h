@@ -5,9 +5,12 @@
 #include "ns3/network-module.h"
 #include "ant-packet.h"
 #include "neighbor.h"
+#include "anthocnet-config.h"
 
 #include <memory>
 #include <map>
+#include <iostream>
+#include <functional>
 
 namespace ns3 {
 namespace ant_routing {
@@ -99,6 +102,41 @@ private:
   std::pair<Neighbor, bool> m_opt;
 };
 
+// non-owning view over the neighbors of a routing table, iterating it does
+// not allocate or copy neighbors. The view is invalidated when neighbors are
+// added to or removed from the table.
+class NeighborView {
+public:
+  using const_iterator = const Neighbor*;
+
+  NeighborView(const Neighbor* first, const Neighbor* last)
+    : m_begin(first), m_end(last) { }
+
+  const_iterator begin() const {
+    return m_begin;
+  }
+
+  const_iterator end() const {
+    return m_end;
+  }
+
+  std::size_t size() const {
+    return m_end - m_begin;
+  }
+
+  bool empty() const {
+    return m_begin == m_end;
+  }
+
+  const Neighbor& operator[](std::size_t index) const {
+    return m_begin[index];
+  }
+
+private:
+  const Neighbor* m_begin;
+  const Neighbor* m_end;
+};
+
 /**
  * Class representing the routing table used to route ants and packages.
  * For each destination in the table, a pheromone value is kept for each of the
@@ -108,6 +146,9 @@ class AntRoutingTable {
 public:
   // todo: check if default constructors are good enough, or modification is needed.
   AntRoutingTable();
+  // creates a routing table using the given configuration, the default
+  // constructor uses the process wide default configuration.
+  explicit AntRoutingTable(std::shared_ptr<AnthocnetConfig> config);
 
   // Routing methods:
 
@@ -149,10 +190,15 @@ public:
   bool HasPheromoneEntryFor(Ipv4Address neighbor, Ipv4Address destination);
 
   void DeletePheromoneEntryFor(Ipv4Address neighbor, Ipv4Address destination);
-  // gets the pheromone entry for the given neighbor and destination address
+  // gets a copy of the pheromone entry for the given neighbor and destination
+  // address. Returns a nullpointer in case there is no such entry.
   const std::shared_ptr<PheromoneEntry> GetPheromone(Ipv4Address neighbor, Ipv4Address destination);
   // setter for pheromone values.
   void SetPheromoneAt(Ipv4Address neighbor, Ipv4Address destination, const PheromoneEntry& entry);
+  // the current pheromone value of the neighbor for the destination and the
+  // highest value among all the neighbors. 0 in case there is no entry.
+  double PheromoneValue(Ipv4Address neighbor, Ipv4Address destination);
+  double BestPheromoneValue(Ipv4Address destination);
 
   // neighbor management:
   void AddNeighbor(const Neighbor& nb);
@@ -181,10 +227,56 @@ public:
   bool IsNeighbor(Ipv4Address addr);
   // returns a vector containing all the neighbors registered in the
   // routing table.
-
+  // note: allocates, prefer NeighborsView or ForEachNeighbor
   std::vector<NeighborKey> Neighbors();
 
+  // non-owning access to the neighbors, see NeighborView
+  NeighborView NeighborsView() const;
+  std::size_t NeighborCount() const;
+
+  // calls the visitor with each neighbor of the table
+  template<typename Visitor>
+  void ForEachNeighbor(Visitor visitor) const {
+    for(auto& neighbor : NeighborsView()) {
+      visitor(neighbor);
+    }
+  }
+
+  // calls the visitor with each neighbor without a pheromone entry for
+  // the destination
+  template<typename Visitor>
+  void ForEachNoPheromoneNeighbor(Ipv4Address destination, Visitor visitor) {
+    auto neighbors = NeighborsView();
+    auto row = PheromoneRow(destination);
+    for(std::size_t nb = 0; nb < neighbors.size(); nb++) {
+      if(row == nullptr || !row[nb]) {
+        visitor(neighbors[nb]);
+      }
+    }
+  }
+
+  // statistics of the pheromone based route lookups: lookups of a destination
+  // with entries in the table (hits), without entries (misses) and the number
+  // of destinations evicted because the table was full.
+  uint64_t LookupHits() const;
+  uint64_t LookupMisses() const;
+  uint64_t Evictions() const;
+  // number of destinations with at least one pheromone entry
+  std::size_t DestinationCount() const;
+
+  // snapshots: writes the neighbors and all the pheromone entries (value,
+  // hop count and time estimate) to the stream in a compact binary format.
+  // The values are written as they are at the current simulation time.
+  void SaveSnapshot(std::ostream& os);
+  // reads a snapshot written by SaveSnapshot and merges it into the table.
+  // Neighbors that are not yet in the table are obtained from the factory.
+  // Returns false in case the stream does not contain a valid snapshot, in
+  // which case the table may hold part of the snapshot.
+  bool LoadSnapshot(std::istream& is, std::function<Neighbor(Ipv4Address)> neighborFactory);
+
   // static variables to configure the calulcations on the ant-routing table.
+  // These access the default configuration (see AnthocnetConfig::Defaults),
+  // routers configured through the AnthocnetHelper use their own copy.
   static double AntBeta();
   static void   AntBeta(double antBeta);
 
@@ -203,33 +295,39 @@ public:
   static double BestEstCoeff();
   static void   BestEstCoeff(double coeff);
 
+  // pheromone evaporation, the pheromone values decay exponentially at the
+  // given rate (per second). Entries dropping below the threshold are removed
+  // from the table. A rate of 0 disables evaporation.
+  static double EvaporationRate();
+  static void   EvaporationRate(double rate);
+
+  static double EvaporationThreshold();
+  static void   EvaporationThreshold(double threshold);
+
+  // maximum number of destinations kept in the table, when full the least
+  // recently looked up destination is evicted. 0 means unbounded.
+  static uint32_t MaxDestinations();
+  static void     MaxDestinations(uint32_t maxDestinations);
+
 private:
 
-  // instance variables:
-  using DestAddr      = Ipv4Address;
-  using NeighborTable = std::map<DestAddr, std::shared_ptr<PheromoneEntry>>;
-  using RoutingTableType = std::map<NeighborKey, std::shared_ptr<NeighborTable>>;
-  // TODO if ever multiple local variables use a pimpl type!
-  std::shared_ptr<RoutingTableType> m_table;
-
-  // static variables:
-  static double s_antBeta; // exploration exponent for the ants
-  static double s_packetBeta; // exploration exponent for the packets
-  static double s_gamma; // influence factor for new pheromones
-  static Time   s_hopTime; // time to make a hop in the system (estimate)
-  static double s_bestEstCoeff; // coefficient used to update the best hop and time estimate
-  static double s_rho; // coefficient for determining the balance between the impact of the hop count and time estimate;
+  // pimpl, holds the dense pheromone matrix. Copies of the routing table
+  // share the same underlying data.
+  struct AntRoutingTableImpl;
+  std::shared_ptr<AntRoutingTableImpl> m_impl;
 
   // auxillary methods
 
   // general function that generates a route from source to destination based
   // on the data in the table and the provided bete (explorative behavior)
-  Ptr<Ipv4Route> RouteTo(Ipv4Address source, Ipv4Address destination, double beta);
-  OptNeighbor RouteToNeighbor(Ipv4Address source, Ipv4Address destination, double beta);
-
-  // retrieves the pheromone table of a single neighbor. In case there is no
-  // such entry, return a nullpointer
-  std::shared_ptr<NeighborTable> GetNeighborTable(NeighborKey neighbor);
+  // in case smooth is set, the neighbor is chosen by smooth weighted
+  // round-robin instead of a random draw.
+  Ptr<Ipv4Route> RouteTo(Ipv4Address source, Ipv4Address destination, double beta, bool smooth = false);
+  OptNeighbor RouteToNeighbor(Ipv4Address source, Ipv4Address destination, double beta, bool smooth = false);
+
+  // flags (indexed like NeighborsView) telling which neighbors have an entry
+  // for the destination, nullptr in case there are no entries.
+  const uint8_t* PheromoneRow(Ipv4Address destination);
 
   // calculates the total pheromone for a destination with a given
   // beta which serves to configure the explorative behavior of the packet.
@@ -12,21 +12,22 @@
 #include "ant-routing-table.h"
 #include "neighbor-manager.h"
 #include "reactive-queue.h"
+#include "flow-table.h"
 #include "ns3/nstime.h"
+#include <fstream>
+#include <map>
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("AnthocnetRoutingProtocol");
 
 namespace ant_routing {
 
-Time AnthocnetRouting::s_helloInterval = MilliSeconds(3000);
-double AnthocnetRouting::s_proactiveProbability = 0.10;
-bool   AnthocnetRouting::s_proactiveEnabled = true;
-
 struct AnthocnetRouting::AnthocnetImpl {
 
   AnthocnetImpl();
 
+  // the configuration of the router, shared with its components
+  std::shared_ptr<AnthocnetConfig> m_config;
   // the sole device used for communication with the outside world
   AntNetDevice m_device;
   // the routing table used by the algorithm to route packets
@@ -38,10 +39,15 @@ struct AnthocnetRouting::AnthocnetImpl {
   // Queue that will hold all the packets that are waiting for the reactive path setup
   // to be completed
   ReactiveQueue m_reactiveQueue;
+  // pins the data flows to a next hop, used when flow pinning is enabled
+  FlowTable m_flowTable;
   // the address of the wifi interface attached
   Ipv4InterfaceAddress m_ifAddress;
   // Timer for the hello messages
   Timer m_helloTimer;
+  // ip address of the neighbors by mac address, learned from the ants they
+  // sent (an ant is always sent by the node in its ip source)
+  std::map<Address, Ipv4Address> m_overheardSenders;
   // the socket used for unicast messages in UDP
   Ptr<Socket> m_socket;
   // broadcast socket used for unicast messages in UDP
@@ -54,11 +60,13 @@ struct AnthocnetRouting::AnthocnetImpl {
 };
 
 AnthocnetRouting::AnthocnetImpl::AnthocnetImpl()
-  : m_device(AntNetDevice()),
-    m_routingTable(AntRoutingTable()),
+  : m_config(std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults())),
+    m_device(AntNetDevice(Ptr<NetDevice>(), m_config)),
+    m_routingTable(AntRoutingTable(m_config)),
     m_neighborManager(NeighborManager()),
     m_antHill(AntHill()),
     m_reactiveQueue(ReactiveQueue()),
+    m_flowTable(FlowTable(m_config)),
     m_ifAddress(Ipv4InterfaceAddress()),
     m_helloTimer(Timer::CANCEL_ON_DESTROY),
     m_socket(Ptr<Socket>()),
@@ -72,8 +80,8 @@ AnthocnetRouting::AnthocnetImpl::AnthocnetImpl()
 
   m_antHill.AddQueen(std::make_shared<BackwardQueen>());
   m_antHill.AddQueen(std::make_shared<ProactiveQueen>());
-  m_antHill.AddQueen(std::make_shared<ReactiveQueen>());
-  m_antHill.AddQueen(std::make_shared<RepairQueen>());
+  m_antHill.AddQueen(std::make_shared<ReactiveQueen>(m_config));
+  m_antHill.AddQueen(std::make_shared<RepairQueen>(m_config));
   m_antHill.AddQueen(std::make_shared<HelloQueen>());
   m_antHill.AddQueen(std::make_shared<LinkFailureQueen>());
 }
@@ -137,6 +145,38 @@ AnthocnetRouting::GetReactiveQueue() {
   return m_impl -> m_reactiveQueue;
 }
 
+std::shared_ptr<const AnthocnetConfig>
+AnthocnetRouting::GetConfig() {
+  return m_impl -> m_config;
+}
+
+void
+AnthocnetRouting::SetConfig(const AnthocnetConfig& config) {
+  // copy in place, the components hold on to the same configuration
+  *(m_impl -> m_config) = config;
+}
+
+bool
+AnthocnetRouting::SaveSnapshot(std::string fileName) {
+  std::ofstream os(fileName, std::ios::binary);
+  if(!os) {
+    return false;
+  }
+
+  m_impl -> m_neighborManager.SaveSnapshot(os);
+  return static_cast<bool>(os);
+}
+
+bool
+AnthocnetRouting::LoadSnapshot(std::string fileName) {
+  std::ifstream is(fileName, std::ios::binary);
+  if(!is) {
+    return false;
+  }
+
+  return m_impl -> m_neighborManager.LoadSnapshot(is);
+}
+
 Ptr<Socket>
 AnthocnetRouting::GetUnicastSocket() {
   return m_impl -> m_socket;
@@ -156,7 +196,7 @@ Ptr<Ipv4Route> AnthocnetRouting::RouteOutput (Ptr<Packet> packet,
   route->SetGateway(Ipv4Address(localhost));
   route->SetOutputDevice(m_impl -> m_loopback);
 
-  if(!IsUdpForAnthocnet(packet, header) && GetProactiveEnabled()) {
+  if(!IsUdpForAnthocnet(packet, header) && m_impl -> m_config -> proactiveEnabled) {
     MaybeSendProactiveAnt(packet, header);
   }
 
@@ -242,7 +282,9 @@ bool
 AnthocnetRouting::HandleIngressForward(Ptr<const Packet> packet,
                             const Ipv4Header& header, uint32_t ingressInterfaceIndex,
                             UnicastForwardCallback ufcb, ErrorCallback ecb) {
-  auto optNeighbor = GetRoutingTable().RoutePacket(header);
+  auto optNeighbor = m_impl -> m_config -> flowPinning
+                   ? m_impl -> m_flowTable.Route(packet, header, GetRoutingTable())
+                   : GetRoutingTable().RoutePacket(header);
   NS_LOG_UNCOND("router " << GetAddress() << "@" << Simulator::Now().GetSeconds()<< " s : routing input: from " << header.GetSource() << " to: " << header.GetDestination() << " - Ingress");
   NS_LOG_UNCOND("has pheromone entry for " << header.GetDestination() << ": " << GetRoutingTable().HasPheromoneEntryFor(header.GetDestination()));
 
@@ -306,7 +348,7 @@ AnthocnetRouting::IsUdpForAnthocnet(Ptr<const Packet> packet, const Ipv4Header&
 void
 AnthocnetRouting::MaybeSendProactiveAnt(Ptr<const Packet> packet, const Ipv4Header& header) {
   double r;
-  if((r = GetRand()) < GetProactiveProbability()) {
+  if((r = GetRand()) < m_impl -> m_config -> proactiveProbability) {
     NS_LOG_UNCOND(GetAddress() << "@" << Simulator::Now() << "- sent out proactive ant from: " << GetAddress()<< "to: " << header.GetDestination());
     ProactiveAnt ant(GetAddress(), header.GetDestination());
     ant.Visit(*this);
@@ -353,6 +395,7 @@ void AnthocnetRouting::NotifyInterfaceUp (uint32_t interface) {
   InstallNeighborFactory();
   InstallLinkFailureCallback();
   InstallRouteRepairCallback();
+  InstallOverhearing();
 }
 
 void AnthocnetRouting::InstallSockets() {
@@ -409,7 +452,7 @@ void AnthocnetRouting::InstallLinkFailureCallback() {
     packet -> AddHeader(notification);
     AntTypeHeader typeHeader(AntType::LinkFailureAnt);
     packet -> AddHeader(typeHeader);
-    device.SubmitExpedited(MakeSendQueueEntry<BroadcastQueueEntry>(broadcastSocket, packet, 0, InetSocketAddress(ifAddress.GetBroadcast(), ANTHOCNET_PORT)));
+    device.EmplaceExpedited<BroadcastQueueEntry>(broadcastSocket, packet, 0, InetSocketAddress(ifAddress.GetBroadcast(), ANTHOCNET_PORT));
     NS_LOG_UNCOND("Link failure called!");
   });
 }
@@ -425,6 +468,41 @@ void AnthocnetRouting::InstallRouteRepairCallback() {
   };
 }
 
+void AnthocnetRouting::InstallOverhearing() {
+  if(!m_impl -> m_config -> overhearNeighbors) {
+    if(m_impl -> m_config -> helloSuppression) {
+      NS_LOG_WARN("Hello suppression requires overhearing the neighbors, the hellos are not suppressed");
+    }
+    return;
+  }
+
+  // a promiscuous handler also gets the frames addressed to other nodes
+  GetObject<Node>() -> RegisterProtocolHandler(MakeCallback(&AnthocnetRouting::OverhearFrame, this),
+                                               Ipv4L3Protocol::PROT_NUMBER, m_impl -> m_device.Device(), true);
+}
+
+void
+AnthocnetRouting::OverhearFrame(Ptr<NetDevice> device, Ptr<const Packet> frame, uint16_t protocol,
+                                const Address& from, const Address& to, NetDevice::PacketType type) {
+  Ptr<Packet> packet = frame -> Copy();
+  Ipv4Header header;
+  packet -> RemoveHeader(header);
+
+  if(IsUdpForAnthocnet(packet, header)) {
+    m_impl -> m_overheardSenders[from] = header.GetSource();
+  }
+
+  // broadcasts are handled by the ants themselves
+  if(type != NetDevice::PACKET_HOST && type != NetDevice::PACKET_OTHERHOST) {
+    return;
+  }
+
+  auto sender = m_impl -> m_overheardSenders.find(from);
+  if(sender != m_impl -> m_overheardSenders.end()) {
+    GetNeighborManager().OtherMessageReceived(sender -> second, GetInterfaceAddress());
+  }
+}
+
 void AnthocnetRouting::NotifyInterfaceDown (uint32_t interface) {
   NS_LOG_UNCOND("Interface down: " << interface);
 }
@@ -454,7 +532,7 @@ void AnthocnetRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time:
 void AnthocnetRouting::DoInitialize() {
   m_impl -> m_helloTimer.Cancel();
   m_impl -> m_helloTimer.SetFunction(&AnthocnetRouting::HelloTimerExpire, this);
-  Time startTime = Time(int64x64_t(GetRand()) * GetHelloTimerInterval());
+  Time startTime = Time(int64x64_t(GetRand()) * m_impl -> m_config -> helloInterval);
   NS_LOG_UNCOND("Start time: " <<  startTime.GetSeconds());
   m_impl -> m_helloTimer.Schedule(startTime);
   Ipv4RoutingProtocol::DoInitialize();
@@ -467,7 +545,18 @@ AnthocnetRouting::HelloTimerExpire() {
   // if the broadcast socket is not yet initialized, wait
   if(!(m_impl->m_broadcastSocket)){
     NS_LOG_UNCOND("No broadcast socket set");
-    m_impl -> m_helloTimer.Schedule(s_helloInterval);
+    m_impl -> m_helloTimer.Schedule(m_impl -> m_config -> helloInterval);
+  }
+
+  // the neighbors already know the node is alive if they overheard it sending
+  // something else than its hellos (only if they overhear the traffic)
+  auto config = m_impl -> m_config;
+  auto interval = config -> helloInterval;
+  if(config -> helloSuppression && config -> overhearNeighbors
+     && m_impl -> m_device.LastTransmission() + interval > Simulator::Now()) {
+    NS_LOG_DEBUG("Suppressed hello, transmitted at: " << m_impl -> m_device.LastTransmission().GetSeconds());
+    m_impl -> m_helloTimer.Schedule(interval);
+    return;
   }
 
   Ptr<Packet> packet = Create<Packet>();
@@ -476,26 +565,26 @@ AnthocnetRouting::HelloTimerExpire() {
   AntTypeHeader typeHeader(AntType::HelloAnt);
   packet -> AddHeader(typeHeader);
 
-  m_impl -> m_device.SubmitExpedited(MakeSendQueueEntry<BroadcastQueueEntry>(m_impl->m_broadcastSocket, packet, 0, InetSocketAddress(m_impl -> m_ifAddress.GetBroadcast(), ANTHOCNET_PORT)));
+  m_impl -> m_device.EmplaceExpedited<BroadcastQueueEntry>(m_impl->m_broadcastSocket, packet, 0, InetSocketAddress(m_impl -> m_ifAddress.GetBroadcast(), ANTHOCNET_PORT));
   // m_impl -> m_broadcastSocket -> SendTo(packet, 0, InetSocketAddress(m_impl->m_ifAddress.GetBroadcast(), ANTHOCNET_PORT));
-  m_impl -> m_helloTimer.Schedule(s_helloInterval);
+  m_impl -> m_helloTimer.Schedule(m_impl -> m_config -> helloInterval);
   NS_LOG_UNCOND("Sent hello packet from: " << m_impl -> m_ifAddress.GetLocal() << " to: " << m_impl -> m_ifAddress.GetBroadcast());
 }
 
 
 void
 AnthocnetRouting::BroadcastExpedited(Ptr<Packet> packet) {
-    m_impl -> m_device.SubmitExpedited(MakeSendQueueEntry<BroadcastQueueEntry>(m_impl->m_broadcastSocket, packet, 0, InetSocketAddress(m_impl -> m_ifAddress.GetBroadcast(), ANTHOCNET_PORT)));
+    m_impl -> m_device.EmplaceExpedited<BroadcastQueueEntry>(m_impl->m_broadcastSocket, packet, 0, InetSocketAddress(m_impl -> m_ifAddress.GetBroadcast(), ANTHOCNET_PORT));
 }
 
 void
 AnthocnetRouting::SetHelloTimerInterval(Time interval) {
-  s_helloInterval = interval;
+  AnthocnetConfig::Defaults() -> helloInterval = interval;
 }
 
 Time
 AnthocnetRouting::GetHelloTimerInterval() {
-  return s_helloInterval;
+  return AnthocnetConfig::Defaults() -> helloInterval;
 }
 
 void
@@ -504,22 +593,22 @@ AnthocnetRouting::SetProactiveProbability(double probability) {
     return;
   }
 
-  s_proactiveProbability = probability;
+  AnthocnetConfig::Defaults() -> proactiveProbability = probability;
 }
 
 double
 AnthocnetRouting::GetProactiveProbability() {
-  return s_proactiveProbability;
+  return AnthocnetConfig::Defaults() -> proactiveProbability;
 }
 
 bool
 AnthocnetRouting::GetProactiveEnabled() {
-  return s_proactiveEnabled;
+  return AnthocnetConfig::Defaults() -> proactiveEnabled;
 }
 
 void
 AnthocnetRouting::SetProactiveEnabled(bool activated) {
-  s_proactiveEnabled = activated;
+  AnthocnetConfig::Defaults() -> proactiveEnabled = activated;
 }
 
 
@@ -540,10 +629,26 @@ AnthocnetRouting::ReceiveAnt(Ptr<Socket> socket) {
   // InetSockAddress inetSourceAddr = InetSockAddress::ConvertFrom(sourceAddr);
   // Ipv4Address sender = inetSourceAddr.GetIpv4();
   // Ipv4Address receiver = m_impl -> m_ifAddress.GetLocal();
+  HandleAnt(packet);
+}
+
+void
+AnthocnetRouting::HandleAnt(Ptr<Packet> packet) {
   AntTypeHeader typeHeader;
   packet->RemoveHeader(typeHeader);
   // TODO integrity check? see if we received garbage?
 
+  if(typeHeader.GetAntType() == AntType::AggregateAnt) {
+    std::vector<Ptr<Packet>> ants;
+    if(!AggregateHeader::Unpack(packet, ants)) {
+      NS_LOG_WARN("Broken aggregate received at: " << m_impl -> m_ifAddress);
+    }
+    for(auto ant : ants) {
+      HandleAnt(ant);
+    }
+    return;
+  }
+
   // TODO add methods to check if ttl is right etc, where are we going to place this
   // responsibility?
   auto ant = m_impl->m_antHill.CreateFrom(typeHeader, packet);
@@ -6,6 +6,7 @@
 #include "ns3/internet-module.h"
 #include "ns3/network-module.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "anthocnet-config.h"
 #include <memory>
 
 namespace ns3 {
@@ -135,6 +136,20 @@ public:
   Ipv4Address GetAddress();
   Ipv4InterfaceAddress GetInterfaceAddress();
 
+  // the configuration of the router, shared with the routing table, the
+  // device and the queens. A new router starts from a copy of the
+  // default configuration (AnthocnetConfig::Defaults).
+  std::shared_ptr<const AnthocnetConfig> GetConfig();
+  void SetConfig(const AnthocnetConfig& config);
+
+  // saves the neighbors and the routing table to a binary file, such that
+  // a later simulation can be warm-started from it with LoadSnapshot.
+  // Loading requires the interface of the router to be up.
+  bool SaveSnapshot(std::string fileName);
+  bool LoadSnapshot(std::string fileName);
+
+  // the static accessors operate on the default configuration, they only
+  // affect routers created afterwards.
   static void SetHelloTimerInterval(Time interval);
   static Time GetHelloTimerInterval();
 
@@ -152,16 +167,24 @@ private:
 
   // callback for when a message is received at the routing protocol socket
   void ReceiveAnt(Ptr<Socket> socket);
+  // unpacks the ant (or the aggregate of ants) and lets it visit the router
+  void HandleAnt(Ptr<Packet> packet);
 
   // hello timer, will send hello messages to everyone in the vicinity
   void HelloTimerExpire();
 
+  // protocol handler for all the ipv4 frames received or overheard by the
+  // device, refreshes the neighbor that sent the frame
+  void OverhearFrame(Ptr<NetDevice> device, Ptr<const Packet> frame, uint16_t protocol,
+                     const Address& from, const Address& to, NetDevice::PacketType type);
+
   // install the sockets needed by the anthocnet routing
   void InstallSockets();
   // used to make the life of the neighbor monitor easier
   void InstallNeighborFactory();
   void InstallLinkFailureCallback();
   void InstallRouteRepairCallback();
+  void InstallOverhearing();
 
 
   // broadcasts the packet to all the neighbor of the node in an expedited way
@@ -196,10 +219,6 @@ private:
     static Ptr<UniformRandomVariable> randGen = CreateObject<UniformRandomVariable> ();
     return randGen -> GetValue(0, 1);
   }
-  // statics
-  static Time s_helloInterval;
-  static double s_proactiveProbability;
-  static bool   s_proactiveEnabled;
   // constants:
   static constexpr const char* localhost = "127.0.0.1";
 
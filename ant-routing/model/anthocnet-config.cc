@@ -0,0 +1,13 @@
+#include "anthocnet-config.h"
+
+namespace ns3 {
+namespace ant_routing {
+
+std::shared_ptr<AnthocnetConfig>
+AnthocnetConfig::Defaults() {
+  static auto defaults = std::make_shared<AnthocnetConfig>();
+  return defaults;
+}
+
+} // namespace ant_routing
+} // namespace ns3
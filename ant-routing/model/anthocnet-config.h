@@ -0,0 +1,108 @@
+#ifndef ANTHOCNET_CONFIG_H
+#define ANTHOCNET_CONFIG_H
+
+#include "ns3/nstime.h"
+
+#include <memory>
+
+namespace ns3 {
+namespace ant_routing {
+
+// how the next hop of data packets is chosen among the neighbors with
+// pheromone for the destination, in proportion to value^packetBeta.
+enum class PacketSelection : uint8_t
+{
+  // a random draw for every packet
+  Stochastic = 0,
+  // smooth weighted round-robin, spreads the packets evenly over time
+  WeightedRoundRobin = 1
+};
+
+// Configuration of a single anthocnet router. The router shares its
+// configuration with the routing table, the device and the queens it owns,
+// such that routers within the same simulation can be configured differently.
+struct AnthocnetConfig {
+
+  // routing table
+  double   antBeta = 1.0; // exploration exponent for the ants
+  double   packetBeta = 2.0; // exploration exponent for the packets
+  double   gamma = 0.7; // influence factor for new pheromones [0, 1]
+  double   rho = 0.5; // balance between the hop count and time estimate [0, 1]
+  Time     hopTime = MilliSeconds(3); // time to make a hop in the system (estimate)
+  double   bestEstCoeff = 0.7; // coefficient to update the best hop and time estimates [0, 1]
+  double   evaporationRate = 0.0; // decay rate of the pheromones per second, 0 disables
+  double   evaporationThreshold = 1e-3; // pheromone value below which entries are removed
+  uint32_t maxDestinations = 0; // capacity of the table in destinations, 0 for unbounded
+  PacketSelection packetSelection = PacketSelection::Stochastic; // ants are always routed stochastically
+
+  // flow pinning (see FlowTable)
+  bool     flowPinning = false;
+  Time     flowPinInterval = Seconds(1); // how long a flow keeps its next hop
+  double   flowPinFraction = 0.5; // minimal pheromone of the pinned hop relative to the best [0, 1]
+  uint32_t maxFlows = 1024; // number of pinned flows, 0 for unbounded
+
+  // router
+  Time   helloInterval = MilliSeconds(3000);
+  double proactiveProbability = 0.10;
+  bool   proactiveEnabled = true;
+  // refresh the neighbors from every unicast frame they send, also the ones
+  // overheard in promiscuous mode. The sender of a frame is known once an
+  // ant was received from its mac address.
+  bool   overhearNeighbors = false;
+  // skip the hello if the node transmitted something else than a hello
+  // within the last hello interval. The neighbors have to overhear the
+  // traffic of the node, so it requires overhearNeighbors.
+  bool   helloSuppression = false;
+
+  // device
+  double      alpha = 0.7; // coefficient of the moving average of the send time
+  std::size_t maxQueueSize = 20;
+  bool        repairEnabled = false;
+  Time        nextHopHoldTime = Seconds(0); // a next hop queue isn't served for this time after a mac failure, zero disables
+  // deficit round robin between the expedited (ants) and standard (data)
+  // lanes. A lane gets weight * laneQuantum bytes per round, a weight of 0
+  // gives the other lane strict priority. The defaults keep the strict
+  // priority of the expedited lane.
+  uint32_t    expeditedLaneWeight = 1;
+  uint32_t    standardLaneWeight = 0;
+  uint32_t    laneQuantum = 1500;
+  Time        laneStarvationBound = Seconds(0); // a lane waiting longer is served first, 0 to disable
+  // codel on the standard lane: entries are dropped at the head of a next
+  // hop queue once their sojourn time stays above the target for an interval
+  bool        codelEnabled = false;
+  Time        codelTarget = MilliSeconds(5);
+  Time        codelInterval = MilliSeconds(100);
+  // broadcast ants waiting at the front of the expedited lane are sent as a
+  // single aggregate frame, if queued within the window of the first one
+  bool        broadcastAggregation = false;
+  Time        aggregationWindow = MilliSeconds(10);
+  uint32_t    maxAggregateSize = 1400; // bytes of ants in a single aggregate
+  // lifetime of the entries in the lanes, an entry that isn't handed to the
+  // mac within its lifetime is skipped. Zero disables the deadline.
+  Time        dataLifetime = Seconds(0); // standard lane
+  Time        antLifetime = Seconds(0); // expedited lane, ants without a lifetime of their own
+  Time        backwardAntLifetime = Seconds(0); // zero uses antLifetime
+  Time        helloLifetime = Seconds(0); // zero uses antLifetime
+  // the entry handed to the mac is failed if the mac didn't report on it
+  // within watchdogFactor times the send time estimate (at least
+  // watchdogMinimum). The minimum must cover the address resolution of a new
+  // neighbor, which retries up to 3 times with a timeout of 1s by default.
+  bool        watchdogEnabled = false;
+  double      watchdogFactor = 50;
+  Time        watchdogMinimum = Seconds(4);
+
+  // ants
+  double reactiveAdmissionRatio = 1.5;
+  double repairAdmissionRatio = 1.5;
+  bool   pheromoneUpdatesOnFailure = true;
+
+  // returns the process wide default configuration. Components that are
+  // created without a configuration share it and the static setters of the
+  // components write to it. New routers start from a copy.
+  static std::shared_ptr<AnthocnetConfig> Defaults();
+};
+
+} // namespace ant_routing
+} // namespace ns3
+
+#endif // ANTHOCNET_CONFIG_H
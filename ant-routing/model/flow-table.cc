@@ -0,0 +1,156 @@
+#include "flow-table.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ant_routing {
+
+// FlowKey definition ----------------------------------------------------------
+FlowKey::FlowKey()
+  : m_protocol(0), m_sourcePort(0), m_destinationPort(0) { }
+
+FlowKey::FlowKey(Ptr<const Packet> packet, const Ipv4Header& header)
+  : m_source(header.GetSource()), m_destination(header.GetDestination()),
+    m_protocol(header.GetProtocol()), m_sourcePort(0), m_destinationPort(0) {
+
+  // the ipv4 header is already removed, the packet starts with the l4 header
+  if(m_protocol == UdpL4Protocol::PROT_NUMBER) {
+    UdpHeader udpHeader;
+    packet -> PeekHeader(udpHeader);
+    m_sourcePort = udpHeader.GetSourcePort();
+    m_destinationPort = udpHeader.GetDestinationPort();
+  } else if(m_protocol == TcpL4Protocol::PROT_NUMBER) {
+    TcpHeader tcpHeader;
+    packet -> PeekHeader(tcpHeader);
+    m_sourcePort = tcpHeader.GetSourcePort();
+    m_destinationPort = tcpHeader.GetDestinationPort();
+  }
+}
+
+bool operator==(const FlowKey& lhs, const FlowKey& rhs) {
+  return lhs.m_source == rhs.m_source
+      && lhs.m_destination == rhs.m_destination
+      && lhs.m_protocol == rhs.m_protocol
+      && lhs.m_sourcePort == rhs.m_sourcePort
+      && lhs.m_destinationPort == rhs.m_destinationPort;
+}
+
+std::size_t
+FlowKeyHash::operator()(const FlowKey& key) const {
+  uint64_t addresses = (static_cast<uint64_t>(key.m_source.Get()) << 32) | key.m_destination.Get();
+  uint64_t rest = (static_cast<uint64_t>(key.m_protocol) << 32)
+                | (static_cast<uint64_t>(key.m_sourcePort) << 16) | key.m_destinationPort;
+  // mix both halves (multiplicative hashing)
+  uint64_t hash = addresses * 0x9e3779b97f4a7c15ULL;
+  hash ^= rest + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  return static_cast<std::size_t>(hash ^ (hash >> 32));
+}
+
+// FlowTableImpl definition ----------------------------------------------------
+struct FlowTable::FlowTableImpl {
+
+  struct Pin {
+    Ipv4Address m_neighbor;
+    Time m_pinnedAt;
+  };
+
+  explicit FlowTableImpl(std::shared_ptr<AnthocnetConfig> config);
+
+  bool IsExpired(const Pin& pin) const;
+  // removes the expired pins, the oldest half of the pins in case
+  // none has expired yet.
+  void Reclaim();
+
+  std::shared_ptr<AnthocnetConfig> m_config;
+  std::unordered_map<FlowKey, Pin, FlowKeyHash> m_pins;
+};
+
+FlowTable::FlowTableImpl::FlowTableImpl(std::shared_ptr<AnthocnetConfig> config)
+  : m_config(config) { }
+
+bool
+FlowTable::FlowTableImpl::IsExpired(const Pin& pin) const {
+  return Simulator::Now() - pin.m_pinnedAt >= m_config->flowPinInterval;
+}
+
+void
+FlowTable::FlowTableImpl::Reclaim() {
+  auto before = m_pins.size();
+  for(auto it = m_pins.begin(); it != m_pins.end();) {
+    it = IsExpired(it->second) ? m_pins.erase(it) : std::next(it);
+  }
+
+  if(m_pins.size() < before) {
+    return;
+  }
+
+  // all the pins are recent, drop the ones older than the median
+  std::vector<Time> ages;
+  for(auto& pin : m_pins) {
+    ages.push_back(pin.second.m_pinnedAt);
+  }
+  auto median = ages.begin() + ages.size() / 2;
+  std::nth_element(ages.begin(), median, ages.end());
+  for(auto it = m_pins.begin(); it != m_pins.end();) {
+    it = it->second.m_pinnedAt <= *median ? m_pins.erase(it) : std::next(it);
+  }
+}
+
+// FlowTable definition --------------------------------------------------------
+FlowTable::FlowTable() : FlowTable(AnthocnetConfig::Defaults()) { }
+
+FlowTable::FlowTable(std::shared_ptr<AnthocnetConfig> config)
+  : m_impl(std::make_shared<FlowTableImpl>(config)) { }
+
+OptNeighbor
+FlowTable::Route(Ptr<const Packet> packet, const Ipv4Header& header, AntRoutingTable table) {
+  auto destination = header.GetDestination();
+  // direct neighbors are not routed via the pheromones
+  if(table.IsNeighbor(destination)) {
+    return table.RoutePacket(header);
+  }
+
+  FlowKey key(packet, header);
+  auto& config = *m_impl->m_config;
+  auto it = m_impl->m_pins.find(key);
+  if(it != m_impl->m_pins.end() && !m_impl->IsExpired(it->second)) {
+    // the pinned neighbor must still be a good route to the destination
+    auto neighbor = it->second.m_neighbor;
+    auto value = table.PheromoneValue(neighbor, destination);
+    auto optNeighbor = table.GetNeighbor(neighbor);
+    if(optNeighbor.IsValid() && value > 0
+       && value >= config.flowPinFraction * table.BestPheromoneValue(destination)) {
+      return optNeighbor;
+    }
+  }
+
+  auto optNeighbor = table.RoutePacket(header);
+  if(!optNeighbor.IsValid()) {
+    return optNeighbor;
+  }
+
+  if(it != m_impl->m_pins.end()) {
+    it->second = FlowTableImpl::Pin{optNeighbor.Get().Address(), Simulator::Now()};
+    return optNeighbor;
+  }
+
+  if(config.maxFlows != 0 && m_impl->m_pins.size() >= config.maxFlows) {
+    m_impl->Reclaim();
+  }
+  m_impl->m_pins.emplace(key, FlowTableImpl::Pin{optNeighbor.Get().Address(), Simulator::Now()});
+  return optNeighbor;
+}
+
+std::size_t
+FlowTable::FlowCount() const {
+  return m_impl->m_pins.size();
+}
+
+void
+FlowTable::Clear() {
+  m_impl->m_pins.clear();
+}
+
+} // namespace ant_routing
+} // namespace ns3
@@ -0,0 +1,58 @@
+#ifndef FLOW_TABLE_H
+#define FLOW_TABLE_H
+
+#include "ant-routing-table.h"
+#include "anthocnet-config.h"
+
+#include <memory>
+
+namespace ns3 {
+namespace ant_routing {
+
+// identifies a flow of data packets by its 5-tuple. The ports are 0 for
+// protocols other than UDP and TCP.
+struct FlowKey {
+  FlowKey();
+  FlowKey(Ptr<const Packet> packet, const Ipv4Header& header);
+
+  Ipv4Address m_source;
+  Ipv4Address m_destination;
+  uint8_t  m_protocol;
+  uint16_t m_sourcePort;
+  uint16_t m_destinationPort;
+};
+
+bool operator==(const FlowKey& lhs, const FlowKey& rhs);
+
+struct FlowKeyHash {
+  std::size_t operator()(const FlowKey& key) const;
+};
+
+// Pins the packets of a flow to the neighbor chosen for its first packet,
+// such that the per packet stochastic routing doesn't reorder the packets
+// of a flow. A pin is released after the pin interval, or earlier in case
+// the pheromone of the pinned neighbor drops below the pin fraction of the
+// best pheromone for the destination. Different flows are still spread
+// over the available paths.
+class FlowTable {
+public:
+  FlowTable();
+  explicit FlowTable(std::shared_ptr<AnthocnetConfig> config);
+
+  // routes the packet of the flow, using the pinned neighbor if the pin is
+  // still valid and the routing table otherwise (creating a new pin).
+  OptNeighbor Route(Ptr<const Packet> packet, const Ipv4Header& header, AntRoutingTable table);
+
+  // number of flows currently pinned (including expired pins not yet reclaimed)
+  std::size_t FlowCount() const;
+  void Clear();
+
+private:
+  struct FlowTableImpl;
+  std::shared_ptr<FlowTableImpl> m_impl;
+};
+
+} // namespace ant_routing
+} // namespace ns3
+
+#endif // FLOW_TABLE_H
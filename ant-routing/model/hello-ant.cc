@@ -20,7 +20,7 @@ HelloAnt::Visit(AnthocnetRouting router) {
 
   router.GetNeighborManager().HelloReceived(m_header);
   // the routingtable should contain the neighbor we just received.
-  NS_LOG_UNCOND(router.GetRoutingTable().Neighbors().size());
+  NS_LOG_UNCOND(router.GetRoutingTable().NeighborCount());
   NS_ASSERT(router.GetRoutingTable().IsNeighbor(m_header.GetSource()));
 }
 
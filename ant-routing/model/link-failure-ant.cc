@@ -6,13 +6,11 @@
 namespace ns3 {
 namespace ant_routing {
 
-bool LinkFailureAnt::s_pheromoneUpdatesOnFailure = true;
-
 bool LinkFailureAnt::PheromoneUpdatesOnFailureEnabled() {
-  return s_pheromoneUpdatesOnFailure;
+  return AnthocnetConfig::Defaults()->pheromoneUpdatesOnFailure;
 }
 void LinkFailureAnt::PheromoneUpdatesOnFailureEnabled(bool val) {
-  s_pheromoneUpdatesOnFailure = val;
+  AnthocnetConfig::Defaults()->pheromoneUpdatesOnFailure = val;
 }
 
 
@@ -34,6 +32,7 @@ LinkFailureAnt::Visit(AnthocnetRouting router) {
   }
 
   auto rTable = router.GetRoutingTable();
+  auto updateOnFailure = router.GetConfig()->pheromoneUpdatesOnFailure;
 
   std::vector<AlternativeRoute> altRoutes;
   for(auto messageIt = m_header.m_messages.begin(); messageIt != m_header.m_messages.end(); messageIt ++) {
@@ -45,7 +44,7 @@ LinkFailureAnt::Visit(AnthocnetRouting router) {
     // std::cout<< "Was best?: " << wasBest << std::endl;
 
     //update if valid estimates, remove if not
-    if(messageIt -> HasValidEstimates() && PheromoneUpdatesOnFailureEnabled()) {
+    if(messageIt -> HasValidEstimates() && updateOnFailure) {
       rTable.UpdatePheromoneEntry(neighborAddr, dest, messageIt -> bestTimeEstimate, messageIt -> bestHopEstimate);
     } else {
       rTable.DeletePheromoneEntryFor(neighborAddr, dest);
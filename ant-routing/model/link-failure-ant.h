@@ -19,13 +19,12 @@ public:
 
   static constexpr AntType species = AntType::LinkFailureAnt;
 
+  // the static accessors operate on the default configuration
   static bool PheromoneUpdatesOnFailureEnabled();
   static void PheromoneUpdatesOnFailureEnabled(bool val);
 
 private:
 
-  static bool s_pheromoneUpdatesOnFailure;
-
   LinkFailureNotification m_header;
 
   bool LoopDetection(Ipv4Address addr);
@@ -155,6 +155,24 @@ NeighborManager::HandleNeighborFailure(const Neighbor& neighbor) {
   m_impl -> m_failureCallback(messages);
 }
 
+void
+NeighborManager::SaveSnapshot(std::ostream& os) {
+  // the neighbors are part of the routing table
+  m_impl -> m_routingTable.SaveSnapshot(os);
+}
+
+bool
+NeighborManager::LoadSnapshot(std::istream& is) {
+  if(!m_impl -> m_neighborFactory) {
+    return false;
+  }
+
+  auto manager = *this;
+  return m_impl -> m_routingTable.LoadSnapshot(is, [manager] (Ipv4Address address) mutable {
+    return manager.AddNeighbor(address);
+  });
+}
+
 AntRoutingTable
 NeighborManager::RoutingTable() {
   return m_impl -> m_routingTable;
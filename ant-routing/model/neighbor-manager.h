@@ -41,6 +41,14 @@ public:
   FailureDetectorFactoryFunction FailureDectectorFactory();
   void FailureDetectorFactory(FailureDetectorFactoryFunction failureDetectorFactory);
 
+  // writes the neighbors and the routing table to the stream
+  void SaveSnapshot(std::ostream& os);
+  // restores the state written by SaveSnapshot. The neighbors of the
+  // snapshot are added like newly discovered neighbors (with a fresh failure
+  // detector), such that they are dropped again if they don't respond.
+  // Requires the neighbor factory to be set.
+  bool LoadSnapshot(std::istream& is);
+
   static Time HelloInterval();
   static void HelloInterval(Time interval);
 
@@ -1,5 +1,6 @@
 #include "neighbor.h"
 #include "ns3/wifi-module.h"
+#include <unordered_map>
 
 namespace ns3 {
 namespace ant_routing {
@@ -11,9 +12,14 @@ struct Neighbor::NeighborImpl {
   NeighborImpl();
   NeighborImpl(Ipv4Address addr, AntNetDevice device);
 
+  // maximum number of cached routes, the cache is cleared when full
+  static constexpr std::size_t MAX_CACHED_ROUTES = 64;
+
   Ipv4Address m_addr; // the address of the neighbor (used to keep contact & do lookups)
   AntNetDevice m_device; // the device to use to communicate with the neighbor
   std::shared_ptr<NeighborFailureDetector> m_failureDetector; // detector for the given neighbor
+  // routes via this neighbor, keyed by source and destination address
+  std::unordered_map<uint64_t, Ptr<Ipv4Route>> m_routes;
 };
 
 Neighbor::NeighborImpl::NeighborImpl()
@@ -34,13 +40,32 @@ Neighbor::Neighbor(Ipv4Address addr, AntNetDevice device) : m_impl(std::make_sha
 Neighbor::~Neighbor() { }
 
 Ptr<Ipv4Route>
-Neighbor::CreateRoute(Ipv4Address source, Ipv4Address destination) {
+Neighbor::CreateRoute(Ipv4Address source, Ipv4Address destination) const {
   auto route = Create<Ipv4Route>();
   route->SetDestination(destination);
   route->SetSource(source);
   route->SetGateway(this->Address());
-  route->SetOutputDevice(AntDevice().Device());
+  route->SetOutputDevice(m_impl->m_device.Device());
+
+  return route;
+}
+
+Ptr<Ipv4Route>
+Neighbor::CachedRoute(Ipv4Address source, Ipv4Address destination) const {
+  auto key = (static_cast<uint64_t>(source.Get()) << 32) | destination.Get();
+  auto& routes = m_impl->m_routes;
+  auto it = routes.find(key);
+  // the device may have been replaced since the route was created
+  if(it != routes.end() && it->second->GetOutputDevice() == m_impl->m_device.Device()) {
+    return it->second;
+  }
+
+  if(routes.size() >= NeighborImpl::MAX_CACHED_ROUTES) {
+    routes.clear();
+  }
 
+  auto route = CreateRoute(source, destination);
+  routes[key] = route;
   return route;
 }
 
@@ -52,6 +77,7 @@ Neighbor::Address() const {
 void
 Neighbor::Address(Ipv4Address addr) {
   m_impl->m_addr = addr;
+  m_impl->m_routes.clear(); // the gateway of the routes changed
 }
 
 AntNetDevice
@@ -82,25 +108,25 @@ Neighbor::Data(std::shared_ptr<NeighborImpl> data) {
 void
 Neighbor::SubmitPacket(Ptr<Ipv4Route> route, Ptr<const Packet> packet,
                        const Ipv4Header &header, UnicastCallback callback) {
-  AntDevice().Submit(MakeSendQueueEntry<UnicastQueueEntry>(route, packet, header, callback));
+  AntDevice().Emplace<UnicastQueueEntry>(route, packet, header, callback);
 }
 
 void
 Neighbor::SubmitPacket(Ptr<const Packet> packet, const Ipv4Header& header, UnicastCallback callback ) {
-  auto route = CreateRoute(header.GetSource(), header.GetDestination());
+  auto route = CachedRoute(header.GetSource(), header.GetDestination());
   SubmitPacket(route, packet, header, callback);
 }
 
 void
 Neighbor::SubmitExpeditedPacket(Ptr<Ipv4Route> route, Ptr<const Packet> packet,
                                 const Ipv4Header &header, UnicastCallback callback) {
-  AntDevice().SubmitExpedited(MakeSendQueueEntry<UnicastQueueEntry>(route, packet, header, callback));
+  AntDevice().EmplaceExpedited<UnicastQueueEntry>(route, packet, header, callback);
 
 }
 
 void
 Neighbor::SubmitExpeditedPacket(Ptr<const Packet> packet, const Ipv4Header& header, UnicastCallback callback) {
-  auto route = CreateRoute(header.GetSource(), header.GetDestination());
+  auto route = CachedRoute(header.GetSource(), header.GetDestination());
   SubmitExpeditedPacket(route, packet, header, callback);
 }
 
@@ -31,7 +31,11 @@ public:
 
   // creates a route fronm souce to destination based on the configuration
   // of the neighbor
-  Ptr<Ipv4Route> CreateRoute(Ipv4Address source, Ipv4Address destination);
+  Ptr<Ipv4Route> CreateRoute(Ipv4Address source, Ipv4Address destination) const;
+  // same as CreateRoute, but the routes are cached per (source, destination)
+  // pair such that forwarding doesn't allocate a route for every packet.
+  // The returned route is shared and must not be modified.
+  Ptr<Ipv4Route> CachedRoute(Ipv4Address source, Ipv4Address destination) const;
 
   Ipv4Address Address() const;
   void Address(Ipv4Address addr);
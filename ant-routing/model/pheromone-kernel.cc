@@ -0,0 +1,259 @@
+#include "pheromone-kernel.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ANT_KERNEL_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace ns3 {
+namespace ant_routing {
+namespace kernel {
+
+// both implementations evaluate the same approximations in the same order:
+//   log2(x) = e + log2(m) with x = m * 2^e and m in [sqrt(1/2), sqrt(2)),
+//             log(m) = 2 atanh(s) with s = (m - 1) / (m + 1)
+//   2^y     = 2^n * exp(f * ln(2)) with n = round(y) and f in [-1/2, 1/2]
+
+static const double SQRT2 = 1.41421356237309504880;
+static const double LN2   = 0.69314718055994530942;
+static const double LOG2E = 1.44269504088896340736;
+// the range of exponents that can be represented by a normal double
+static const double MIN_EXP2 = -1022;
+static const double MAX_EXP2 = 1023;
+
+static const uint64_t EXPONENT_MASK = 0x7ff0000000000000ULL;
+static const uint64_t MANTISSA_MASK = 0x000fffffffffffffULL;
+static const uint64_t ONE_BITS      = 0x3ff0000000000000ULL;
+
+// coefficients of the series, 1/(2k + 1) for atanh and 1/k! for exp
+static const double ATANH_C1 = 1.0 / 3, ATANH_C2 = 1.0 / 5, ATANH_C3 = 1.0 / 7,
+                    ATANH_C4 = 1.0 / 9, ATANH_C5 = 1.0 / 11;
+static const double EXP_C2 = 1.0 / 2, EXP_C3 = 1.0 / 6, EXP_C4 = 1.0 / 24,
+                    EXP_C5 = 1.0 / 120, EXP_C6 = 1.0 / 720, EXP_C7 = 1.0 / 5040,
+                    EXP_C8 = 1.0 / 40320, EXP_C9 = 1.0 / 362880;
+
+static bool s_forceScalar = false;
+
+// scalar implementation -------------------------------------------------------
+
+static double
+Log2(double x) {
+  uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  double e = static_cast<double>(static_cast<int64_t>((bits & EXPONENT_MASK) >> 52)) - 1023;
+  bits = (bits & MANTISSA_MASK) | ONE_BITS;
+  double m;
+  std::memcpy(&m, &bits, sizeof(m));
+  if(m > SQRT2) {
+    m = m * 0.5;
+    e = e + 1;
+  }
+
+  double s = (m - 1) / (m + 1);
+  double s2 = s * s;
+  double p = ATANH_C5;
+  p = p * s2 + ATANH_C4;
+  p = p * s2 + ATANH_C3;
+  p = p * s2 + ATANH_C2;
+  p = p * s2 + ATANH_C1;
+  p = p * s2 + 1;
+  return e + (2 * s * p) * LOG2E;
+}
+
+static double
+Exp2(double y) {
+  if(y < MIN_EXP2) {
+    return 0;
+  }
+  y = std::min(y, MAX_EXP2);
+
+  double n = std::nearbyint(y);
+  double t = (y - n) * LN2;
+  double p = EXP_C9;
+  p = p * t + EXP_C8;
+  p = p * t + EXP_C7;
+  p = p * t + EXP_C6;
+  p = p * t + EXP_C5;
+  p = p * t + EXP_C4;
+  p = p * t + EXP_C3;
+  p = p * t + EXP_C2;
+  p = p * t + 1;
+  p = p * t + 1;
+
+  uint64_t bits = static_cast<uint64_t>(static_cast<int64_t>(n) + 1023) << 52;
+  double scale;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return p * scale;
+}
+
+double
+FastPow(double value, double beta) {
+  // also filters NaN
+  if(!(value >= DBL_MIN)) {
+    return 0;
+  }
+  return Exp2(beta * Log2(value));
+}
+
+static void
+PowerScalar(const double* in, double* out, std::size_t n, double beta) {
+  for(std::size_t i = 0; i < n; i++) {
+    out[i] = FastPow(in[i], beta);
+  }
+}
+
+static double
+InclusiveScanScalar(const double* in, double* out, std::size_t n, double carry) {
+  for(std::size_t i = 0; i < n; i++) {
+    carry += in[i];
+    out[i] = carry;
+  }
+  return carry;
+}
+
+// AVX2 implementation ---------------------------------------------------------
+#ifdef ANT_KERNEL_AVX2
+
+static bool
+CpuHasAvx2() {
+  static bool hasAvx2 = __builtin_cpu_supports("avx2");
+  return hasAvx2;
+}
+
+__attribute__((target("avx2"))) static void
+PowerAvx2(const double* in, double* out, std::size_t n, double beta) {
+  const __m256d vBeta = _mm256_set1_pd(beta);
+  const __m256d vOne = _mm256_set1_pd(1);
+  const __m256d vHalf = _mm256_set1_pd(0.5);
+  const __m256d vSqrt2 = _mm256_set1_pd(SQRT2);
+  // adding 2^52 to a small non negative integer places it in the low bits
+  const __m256d vMagic = _mm256_set1_pd(4503599627370496.0);
+  const __m256i vMagicBits = _mm256_set1_epi64x(0x4330000000000000LL);
+  const __m256i vMantissaMask = _mm256_set1_epi64x(MANTISSA_MASK);
+  const __m256i vOneBits = _mm256_set1_epi64x(ONE_BITS);
+
+  std::size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    __m256d x = _mm256_loadu_pd(in + i);
+    __m256d valid = _mm256_cmp_pd(x, _mm256_set1_pd(DBL_MIN), _CMP_GE_OQ);
+
+    // log2
+    __m256i bits = _mm256_castpd_si256(x);
+    __m256i exponent = _mm256_srli_epi64(bits, 52);
+    __m256d e = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(exponent, vMagicBits)), vMagic);
+    e = _mm256_sub_pd(e, _mm256_set1_pd(1023));
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, vMantissaMask), vOneBits));
+    __m256d big = _mm256_cmp_pd(m, vSqrt2, _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, vHalf), big);
+    e = _mm256_add_pd(e, _mm256_and_pd(big, vOne));
+
+    __m256d s = _mm256_div_pd(_mm256_sub_pd(m, vOne), _mm256_add_pd(m, vOne));
+    __m256d s2 = _mm256_mul_pd(s, s);
+    __m256d p = _mm256_set1_pd(ATANH_C5);
+    p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(ATANH_C4));
+    p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(ATANH_C3));
+    p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(ATANH_C2));
+    p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(ATANH_C1));
+    p = _mm256_add_pd(_mm256_mul_pd(p, s2), vOne);
+    __m256d lg = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(2), s), p), _mm256_set1_pd(LOG2E));
+    lg = _mm256_add_pd(e, lg);
+
+    // exp2
+    __m256d y = _mm256_mul_pd(vBeta, lg);
+    valid = _mm256_and_pd(valid, _mm256_cmp_pd(y, _mm256_set1_pd(MIN_EXP2), _CMP_GE_OQ));
+    y = _mm256_max_pd(_mm256_min_pd(y, _mm256_set1_pd(MAX_EXP2)), _mm256_set1_pd(MIN_EXP2));
+    __m256d nd = _mm256_round_pd(y, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d t = _mm256_mul_pd(_mm256_sub_pd(y, nd), _mm256_set1_pd(LN2));
+    p = _mm256_set1_pd(EXP_C9);
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(EXP_C8));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(EXP_C7));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(EXP_C6));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(EXP_C5));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(EXP_C4));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(EXP_C3));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_set1_pd(EXP_C2));
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), vOne);
+    p = _mm256_add_pd(_mm256_mul_pd(p, t), vOne);
+
+    __m256d biased = _mm256_add_pd(_mm256_add_pd(nd, _mm256_set1_pd(1023)), vMagic);
+    __m256d scale = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(biased), 52));
+    __m256d result = _mm256_and_pd(_mm256_mul_pd(p, scale), valid);
+    _mm256_storeu_pd(out + i, result);
+  }
+
+  PowerScalar(in + i, out + i, n - i, beta);
+}
+
+__attribute__((target("avx2"))) static double
+InclusiveScanAvx2(const double* in, double* out, std::size_t n) {
+  const __m256d zero = _mm256_setzero_pd();
+  __m256d carry = zero;
+
+  std::size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    // [a, b, c, d] -> [a, a + b, b + c, c + d] -> [a, a + b, a + b + c, a + b + c + d]
+    __m256d v = _mm256_loadu_pd(in + i);
+    __m256d shifted = _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1);
+    v = _mm256_add_pd(v, shifted);
+    v = _mm256_add_pd(v, _mm256_permute2f128_pd(v, v, 0x08));
+    v = _mm256_add_pd(v, carry);
+    _mm256_storeu_pd(out + i, v);
+    carry = _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+
+  return InclusiveScanScalar(in + i, out + i, n - i, _mm256_cvtsd_f64(carry));
+}
+
+#endif // ANT_KERNEL_AVX2
+
+// dispatch --------------------------------------------------------------------
+
+bool
+SimdEnabled() {
+#ifdef ANT_KERNEL_AVX2
+  return !s_forceScalar && CpuHasAvx2();
+#else
+  return false;
+#endif
+}
+
+void
+ForceScalar(bool scalar) {
+  s_forceScalar = scalar;
+}
+
+void
+Power(const double* in, double* out, std::size_t n, double beta) {
+#ifdef ANT_KERNEL_AVX2
+  if(SimdEnabled()) {
+    PowerAvx2(in, out, n, beta);
+    return;
+  }
+#endif
+  PowerScalar(in, out, n, beta);
+}
+
+double
+InclusiveScan(const double* in, double* out, std::size_t n) {
+#ifdef ANT_KERNEL_AVX2
+  if(SimdEnabled()) {
+    return InclusiveScanAvx2(in, out, n);
+  }
+#endif
+  return InclusiveScanScalar(in, out, n, 0);
+}
+
+std::size_t
+SelectIndex(const double* cumulative, std::size_t n, double point) {
+  auto index = std::lower_bound(cumulative, cumulative + n, point) - cumulative;
+  return std::min<std::size_t>(index, n - 1);
+}
+
+} // namespace kernel
+} // namespace ant_routing
+} // namespace ns3
@@ -0,0 +1,40 @@
+#ifndef PHEROMONE_KERNEL_H
+#define PHEROMONE_KERNEL_H
+
+#include <cstddef>
+
+namespace ns3 {
+namespace ant_routing {
+namespace kernel {
+
+// Numerical kernels used by the routing table to turn a row of pheromone
+// values into a selection distribution. On x86-64 processors supporting
+// AVX2 a vectorized implementation is selected at runtime, otherwise (or
+// when forced) the scalar implementation is used. Both implementations
+// produce the same results up to rounding.
+
+// approximation of value^beta using a polynomial exp2/log2. The relative
+// error is below 1e-8 for positive values, non positive values yield 0.
+double FastPow(double value, double beta);
+
+// out[i] = FastPow(in[i], beta), in and out may be the same array
+void Power(const double* in, double* out, std::size_t n, double beta);
+
+// out[i] = in[0] + ... + in[i], returns the total. in and out may be
+// the same array.
+double InclusiveScan(const double* in, double* out, std::size_t n);
+
+// index of the first cumulative value reaching the point, the last index
+// in case rounding errors leave the point beyond the total.
+std::size_t SelectIndex(const double* cumulative, std::size_t n, double point);
+
+// true in case the vectorized implementation is in use
+bool SimdEnabled();
+// forces the scalar implementation, used to compare both implementations
+void ForceScalar(bool scalar);
+
+} // namespace kernel
+} // namespace ant_routing
+} // namespace ns3
+
+#endif // PHEROMONE_KERNEL_H
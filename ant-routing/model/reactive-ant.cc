@@ -95,9 +95,11 @@ ReactiveAnt::GetHeader() {
 struct AntQueenImpl<ReactiveAnt>::GenerationInfo {
 
   GenerationInfo(const AntHeader& header);
-  std::shared_ptr<Ant> CreateFrom(const AntTypeHeader& typeHeader, Ptr<Packet> packet);
+  std::shared_ptr<Ant> CreateFrom(const AntTypeHeader& typeHeader, Ptr<Packet> packet, double admissionRatio);
 
-  bool CanBeAdmitted(const AntHeader& header);
+  // admissionRatio: how much worse the parameters of the Ant may be when
+  // checked against the best ant of the generation (broadcast)
+  bool CanBeAdmitted(const AntHeader& header, double admissionRatio);
   void UpdateGenerationData(const AntHeader& header);
   bool IsBetterAnt(const AntHeader& header);
   bool HasRightAntType(const AntTypeHeader& typeHeader);
@@ -113,11 +115,11 @@ AntQueenImpl<ReactiveAnt>::GenerationInfo::GenerationInfo(const AntHeader& heade
 }
 
 std::shared_ptr<Ant>
-AntQueenImpl<ReactiveAnt>::GenerationInfo::CreateFrom(const AntTypeHeader& typeHeader, Ptr<Packet> packet) {
+AntQueenImpl<ReactiveAnt>::GenerationInfo::CreateFrom(const AntTypeHeader& typeHeader, Ptr<Packet> packet, double admissionRatio) {
   AntHeader header;
   packet -> PeekHeader(header);
 
-  if(!HasRightAntType(typeHeader) || !CanBeAdmitted(header)) {
+  if(!HasRightAntType(typeHeader) || !CanBeAdmitted(header, admissionRatio)) {
     return nullptr;
   }
 
@@ -133,7 +135,7 @@ AntQueenImpl<ReactiveAnt>::GetAntType() {
 
 
 bool
-AntQueenImpl<ReactiveAnt>::GenerationInfo::CanBeAdmitted(const AntHeader& header) {
+AntQueenImpl<ReactiveAnt>::GenerationInfo::CanBeAdmitted(const AntHeader& header, double admissionRatio) {
   NS_LOG_UNCOND("Origin of the ant: " << header.GetSource());
   NS_LOG_UNCOND("Generation of ant: " << header.GetGeneration() << " Current highest: " << m_generation);
   NS_LOG_UNCOND("Time of ant: " << header.GetTimeEstimate() <<" best time: " << m_bestTime);
@@ -150,7 +152,7 @@ AntQueenImpl<ReactiveAnt>::GenerationInfo::CanBeAdmitted(const AntHeader& header
   auto timeRatio = header.GetTimeEstimate() / m_bestTime;
   auto hopRatio  = header.GetHopCount() / m_bestHopCount;
 
-  return timeRatio <= s_admissionRatio && hopRatio <= s_admissionRatio;
+  return timeRatio <= admissionRatio && hopRatio <= admissionRatio;
 }
 
 void
@@ -191,24 +193,24 @@ AntQueenImpl<ReactiveAnt>::GenerationInfo::HasRightAntType(const AntTypeHeader&
 // ReactiveQueen Pimpl ---------------------------------------------------------
 
 struct AntQueenImpl<ReactiveAnt>::ReactiveQueenImpl {
-  ReactiveQueenImpl();
+  explicit ReactiveQueenImpl(std::shared_ptr<AnthocnetConfig> config);
 
   using GenInfoMapType = std::map<Ipv4Address, std::shared_ptr<GenerationInfo>>;
   // generation of the ants produced by the given queen
   uint32_t m_ownGeneration;
   // information about the generations of other recipients
   GenInfoMapType m_generationInfo;
+  // configuration holding the admission ratio
+  std::shared_ptr<AnthocnetConfig> m_config;
 };
 
-AntQueenImpl<ReactiveAnt>::ReactiveQueenImpl::ReactiveQueenImpl()
-  : m_ownGeneration(0), m_generationInfo(GenInfoMapType()) { }
+AntQueenImpl<ReactiveAnt>::ReactiveQueenImpl::ReactiveQueenImpl(std::shared_ptr<AnthocnetConfig> config)
+  : m_ownGeneration(0), m_generationInfo(GenInfoMapType()), m_config(config) { }
 
 
 // ReactiveQueen ---------------------------------------------------------------
 
 // static variables and functions-----------------------------------------------
-double AntQueenImpl<ReactiveAnt>::s_admissionRatio = 1.5;
-
 bool
 AntQueenImpl<ReactiveAnt>::HasRightAntType(const AntTypeHeader& typeHeader) {
   return ReactiveAnt::species == typeHeader.GetAntType();
@@ -216,8 +218,10 @@ AntQueenImpl<ReactiveAnt>::HasRightAntType(const AntTypeHeader& typeHeader) {
 
 
 // instance definitions --------------------------------------------------------
-AntQueenImpl<ReactiveAnt>::AntQueenImpl() :
-  m_impl(std::make_shared<ReactiveQueenImpl>()) {
+AntQueenImpl<ReactiveAnt>::AntQueenImpl() : AntQueenImpl(AnthocnetConfig::Defaults()) { }
+
+AntQueenImpl<ReactiveAnt>::AntQueenImpl(std::shared_ptr<AnthocnetConfig> config) :
+  m_impl(std::make_shared<ReactiveQueenImpl>(config)) {
 
 }
 AntQueenImpl<ReactiveAnt>::~AntQueenImpl() { }
@@ -241,7 +245,7 @@ std::shared_ptr<Ant> AntQueenImpl<ReactiveAnt>::CreateFrom(const AntTypeHeader&
   // if there is an entry for the given source
   if(optInfo != m_impl -> m_generationInfo.end()) {
     auto info = optInfo -> second;
-    return info->CreateFrom(typeHeader, packet);
+    return info->CreateFrom(typeHeader, packet, m_impl -> m_config -> reactiveAdmissionRatio);
   }else { // if no entry for a given sourceL create one
     auto info = std::make_shared<GenerationInfo>(header);
     NS_LOG_UNCOND("Created new geninfo with: best time" << info -> m_bestTime << " and generation: " << info -> m_generation);
@@ -252,7 +256,7 @@ std::shared_ptr<Ant> AntQueenImpl<ReactiveAnt>::CreateFrom(const AntTypeHeader&
 
 double
 AntQueenImpl<ReactiveAnt>::AdmissionRatio() {
-  return s_admissionRatio;
+  return AnthocnetConfig::Defaults()->reactiveAdmissionRatio;
 }
 void
 AntQueenImpl<ReactiveAnt>::AdmissionRatio(double ratio) {
@@ -260,7 +264,7 @@ AntQueenImpl<ReactiveAnt>::AdmissionRatio(double ratio) {
     return;
   }
 
-  s_admissionRatio = ratio;
+  AnthocnetConfig::Defaults()->reactiveAdmissionRatio = ratio;
 }
 
 
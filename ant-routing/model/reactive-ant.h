@@ -1,6 +1,7 @@
 #ifndef REACTIVE_ANT_H
 #define REACTIVE_ANT_H
 #include "forward-ant.h"
+#include "anthocnet-config.h"
 
 namespace ns3 {
 namespace ant_routing {
@@ -43,6 +44,8 @@ template<>
 class AntQueenImpl<ReactiveAnt> : public AntQueen {
 public:
   AntQueenImpl();
+  // creates a queen using the admission ratio of the given configuration
+  explicit AntQueenImpl(std::shared_ptr<AnthocnetConfig> config);
   ~AntQueenImpl();
   // creates a new forward ant
   // param source: the source of the ant (sender of the ant)
@@ -58,6 +61,7 @@ public:
 
   static constexpr AntType species = ReactiveAnt::species;
 
+  // the static accessors operate on the default configuration
   static double AdmissionRatio();
   static void AdmissionRatio(double ratio);
 
@@ -67,9 +71,6 @@ private:
 
   // statics:
   static bool HasRightAntType(const AntTypeHeader& typeHeader);
-  // how much worse the parameters of the Ant may be when checked agianst
-  // the best ant of the generation (broadcast);
-  static double s_admissionRatio;
 
   // dynamics:
   std::shared_ptr<GenerationInfo> getGenerationInfo();
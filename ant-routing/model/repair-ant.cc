@@ -46,9 +46,11 @@ RepairAnt::ToPacket() {
 struct AntQueenImpl<RepairAnt>::GenerationInfo {
 
   GenerationInfo(const AntHeader& header);
-  std::shared_ptr<Ant> CreateFrom(const AntTypeHeader& typeHeader, Ptr<Packet> packet);
+  std::shared_ptr<Ant> CreateFrom(const AntTypeHeader& typeHeader, Ptr<Packet> packet, double admissionRatio);
 
-  bool CanBeAdmitted(const AntHeader& header);
+  // admissionRatio: how much worse the parameters of the Ant may be when
+  // checked against the best ant of the generation (broadcast)
+  bool CanBeAdmitted(const AntHeader& header, double admissionRatio);
   void UpdateGenerationData(const AntHeader& header);
   bool IsBetterAnt(const AntHeader& header);
   bool HasRightAntType(const AntTypeHeader& typeHeader);
@@ -64,11 +66,11 @@ AntQueenImpl<RepairAnt>::GenerationInfo::GenerationInfo(const AntHeader& header)
 }
 
 std::shared_ptr<Ant>
-AntQueenImpl<RepairAnt>::GenerationInfo::CreateFrom(const AntTypeHeader& typeHeader, Ptr<Packet> packet) {
+AntQueenImpl<RepairAnt>::GenerationInfo::CreateFrom(const AntTypeHeader& typeHeader, Ptr<Packet> packet, double admissionRatio) {
   AntHeader header;
   packet -> PeekHeader(header);
 
-  if(!HasRightAntType(typeHeader) || !CanBeAdmitted(header)) {
+  if(!HasRightAntType(typeHeader) || !CanBeAdmitted(header, admissionRatio)) {
     return nullptr;
   }
 
@@ -84,7 +86,7 @@ AntQueenImpl<RepairAnt>::GetAntType() {
 
 
 bool
-AntQueenImpl<RepairAnt>::GenerationInfo::CanBeAdmitted(const AntHeader& header) {
+AntQueenImpl<RepairAnt>::GenerationInfo::CanBeAdmitted(const AntHeader& header, double admissionRatio) {
   NS_LOG_UNCOND("Origin of the ant: " << header.GetSource());
   NS_LOG_UNCOND("Generation of ant: " << header.GetGeneration() << " Current highest: " << m_generation);
   NS_LOG_UNCOND("Time of ant: " << header.GetTimeEstimate() <<" best time: " << m_bestTime);
@@ -101,7 +103,7 @@ AntQueenImpl<RepairAnt>::GenerationInfo::CanBeAdmitted(const AntHeader& header)
   auto timeRatio = header.GetTimeEstimate() / m_bestTime;
   auto hopRatio  = header.GetHopCount() / m_bestHopCount;
 
-  return timeRatio <= s_admissionRatio && hopRatio <= s_admissionRatio;
+  return timeRatio <= admissionRatio && hopRatio <= admissionRatio;
 }
 
 void
@@ -142,24 +144,24 @@ AntQueenImpl<RepairAnt>::GenerationInfo::HasRightAntType(const AntTypeHeader& ty
 // ReactiveQueen Pimpl ---------------------------------------------------------
 
 struct AntQueenImpl<RepairAnt>::ReactiveQueenImpl {
-  ReactiveQueenImpl();
+  explicit ReactiveQueenImpl(std::shared_ptr<AnthocnetConfig> config);
 
   using GenInfoMapType = std::map<Ipv4Address, std::shared_ptr<GenerationInfo>>;
   // generation of the ants produced by the given queen
   uint32_t m_ownGeneration;
   // information about the generations of other recipients
   GenInfoMapType m_generationInfo;
+  // configuration holding the admission ratio
+  std::shared_ptr<AnthocnetConfig> m_config;
 };
 
-AntQueenImpl<RepairAnt>::ReactiveQueenImpl::ReactiveQueenImpl()
-  : m_ownGeneration(0), m_generationInfo(GenInfoMapType()) { }
+AntQueenImpl<RepairAnt>::ReactiveQueenImpl::ReactiveQueenImpl(std::shared_ptr<AnthocnetConfig> config)
+  : m_ownGeneration(0), m_generationInfo(GenInfoMapType()), m_config(config) { }
 
 
 // ReactiveQueen ---------------------------------------------------------------
 
 // static variables and functions-----------------------------------------------
-double AntQueenImpl<RepairAnt>::s_admissionRatio = 1.5;
-
 bool
 AntQueenImpl<RepairAnt>::HasRightAntType(const AntTypeHeader& typeHeader) {
   return RepairAnt::species == typeHeader.GetAntType();
@@ -167,8 +169,10 @@ AntQueenImpl<RepairAnt>::HasRightAntType(const AntTypeHeader& typeHeader) {
 
 
 // instance definitions --------------------------------------------------------
-AntQueenImpl<RepairAnt>::AntQueenImpl() :
-  m_impl(std::make_shared<ReactiveQueenImpl>()) {
+AntQueenImpl<RepairAnt>::AntQueenImpl() : AntQueenImpl(AnthocnetConfig::Defaults()) { }
+
+AntQueenImpl<RepairAnt>::AntQueenImpl(std::shared_ptr<AnthocnetConfig> config) :
+  m_impl(std::make_shared<ReactiveQueenImpl>(config)) {
 
 }
 AntQueenImpl<RepairAnt>::~AntQueenImpl() { }
@@ -192,7 +196,7 @@ std::shared_ptr<Ant> AntQueenImpl<RepairAnt>::CreateFrom(const AntTypeHeader& ty
   // if there is an entry for the given source
   if(optInfo != m_impl -> m_generationInfo.end()) {
     auto info = optInfo -> second;
-    return info->CreateFrom(typeHeader, packet);
+    return info->CreateFrom(typeHeader, packet, m_impl -> m_config -> repairAdmissionRatio);
   }else { // if no entry for a given sourceL create one
     auto info = std::make_shared<GenerationInfo>(header);
     NS_LOG_UNCOND("Created new geninfo with: best time" << info -> m_bestTime << " and generation: " << info -> m_generation);
@@ -203,7 +207,7 @@ std::shared_ptr<Ant> AntQueenImpl<RepairAnt>::CreateFrom(const AntTypeHeader& ty
 
 double
 AntQueenImpl<RepairAnt>::AdmissionRatio() {
-  return s_admissionRatio;
+  return AnthocnetConfig::Defaults()->repairAdmissionRatio;
 }
 void
 AntQueenImpl<RepairAnt>::AdmissionRatio(double ratio) {
@@ -211,7 +215,7 @@ AntQueenImpl<RepairAnt>::AdmissionRatio(double ratio) {
     return;
   }
 
-  s_admissionRatio = ratio;
+  AnthocnetConfig::Defaults()->repairAdmissionRatio = ratio;
 }
 
 
@@ -29,6 +29,8 @@ template<>
 class AntQueenImpl<RepairAnt> : public AntQueen {
 public:
   AntQueenImpl();
+  // creates a queen using the admission ratio of the given configuration
+  explicit AntQueenImpl(std::shared_ptr<AnthocnetConfig> config);
   ~AntQueenImpl();
   // creates a new forward ant
   // param source: the source of the ant (sender of the ant)
@@ -44,6 +46,7 @@ public:
 
   static constexpr AntType species = RepairAnt::species;
 
+  // the static accessors operate on the default configuration
   static double AdmissionRatio();
   static void AdmissionRatio(double ratio);
 
@@ -53,9 +56,6 @@ private:
 
   // statics:
   static bool HasRightAntType(const AntTypeHeader& typeHeader);
-  // how much worse the parameters of the Ant may be when checked agianst
-  // the best ant of the generation (broadcast);
-  static double s_admissionRatio;
 
   // dynamics:
   std::shared_ptr<GenerationInfo> getGenerationInfo();
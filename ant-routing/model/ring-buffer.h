@@ -0,0 +1,100 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ant_routing {
+
+// fifo queue on a fixed array of slots. The slots are allocated once (on
+// construction or Reserve), pushing and popping never allocate as long as the
+// queue stays within its capacity. In case the queue is full, the capacity is
+// doubled (this only happens when the bound of the queue changed).
+// The interface mirrors the one of std::queue.
+template<typename T>
+class RingBuffer {
+public:
+  explicit RingBuffer(std::size_t capacity = 0)
+    : m_slots(capacity), m_head(0), m_size(0) { }
+
+  bool empty() const {
+    return m_size == 0;
+  }
+
+  bool full() const {
+    return m_size == m_slots.size();
+  }
+
+  std::size_t size() const {
+    return m_size;
+  }
+
+  std::size_t capacity() const {
+    return m_slots.size();
+  }
+
+  T& front() {
+    return m_slots[m_head];
+  }
+
+  const T& front() const {
+    return m_slots[m_head];
+  }
+
+  // element at the given position, counted from the front
+  T& operator[](std::size_t index) {
+    return m_slots[Wrap(m_head + index)];
+  }
+
+  void push(T value) {
+    if(full()) {
+      Reserve(m_slots.empty() ? 1 : 2 * m_slots.size());
+    }
+    m_slots[Wrap(m_head + m_size)] = std::move(value);
+    m_size++;
+  }
+
+  void pop() {
+    // reset the slot such that the resources of the element are released
+    m_slots[m_head] = T();
+    m_head = Wrap(m_head + 1);
+    m_size--;
+  }
+
+  void clear() {
+    while(!empty()) {
+      pop();
+    }
+    m_head = 0;
+  }
+
+  // makes room for at least capacity elements, keeping the queued elements
+  void Reserve(std::size_t capacity) {
+    if(capacity <= m_slots.size()) {
+      return;
+    }
+
+    std::vector<T> slots(capacity);
+    for(std::size_t i = 0; i < m_size; i++) {
+      slots[i] = std::move(m_slots[Wrap(m_head + i)]);
+    }
+    m_slots.swap(slots);
+    m_head = 0;
+  }
+
+private:
+  std::size_t Wrap(std::size_t index) const {
+    return index >= m_slots.size() ? index - m_slots.size() : index;
+  }
+
+  std::vector<T> m_slots;
+  std::size_t m_head;
+  std::size_t m_size;
+};
+
+} // namespace ant_routing
+} // namespace ns3
+
+#endif // RING_BUFFER_H
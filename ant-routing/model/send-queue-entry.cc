@@ -9,8 +9,163 @@ NS_LOG_COMPONENT_DEFINE("SendQueueEntry");
 namespace ant_routing {
 
 SendQueueEntry::SendQueueEntry()
-  : m_sending(false), m_sendStartTime(Seconds(0)) { }
+  : m_kind(Kind::Empty), m_sending(false), m_sendStartTime(Seconds(0)), m_enqueueTime(Seconds(0)), m_deadline(Time::Max()) { }
 
+SendQueueEntry::SendQueueEntry(UnicastQueueEntry unicast)
+  : m_kind(Kind::Unicast), m_sending(false), m_sendStartTime(Seconds(0)), m_enqueueTime(Seconds(0)), m_deadline(Time::Max()) {
+  new (&m_unicast) UnicastQueueEntry(std::move(unicast));
+}
+
+SendQueueEntry::SendQueueEntry(BroadcastQueueEntry broadcast)
+  : m_kind(Kind::Broadcast), m_sending(false), m_sendStartTime(Seconds(0)), m_enqueueTime(Seconds(0)), m_deadline(Time::Max()) {
+  new (&m_broadcast) BroadcastQueueEntry(std::move(broadcast));
+}
+
+SendQueueEntry::SendQueueEntry(const SendQueueEntry& other)
+  : m_kind(Kind::Empty), m_sending(other.m_sending), m_sendStartTime(other.m_sendStartTime), m_enqueueTime(other.m_enqueueTime), m_deadline(other.m_deadline) {
+  CopyFrom(other);
+}
+
+SendQueueEntry::SendQueueEntry(SendQueueEntry&& other)
+  : m_kind(Kind::Empty), m_sending(other.m_sending), m_sendStartTime(other.m_sendStartTime), m_enqueueTime(other.m_enqueueTime), m_deadline(other.m_deadline) {
+  MoveFrom(std::move(other));
+}
+
+SendQueueEntry&
+SendQueueEntry::operator=(const SendQueueEntry& other) {
+  if(this != &other) {
+    Reset();
+    CopyFrom(other);
+    m_sending = other.m_sending;
+    m_sendStartTime = other.m_sendStartTime;
+    m_enqueueTime = other.m_enqueueTime;
+    m_deadline = other.m_deadline;
+  }
+  return *this;
+}
+
+SendQueueEntry&
+SendQueueEntry::operator=(SendQueueEntry&& other) {
+  if(this != &other) {
+    Reset();
+    m_sending = other.m_sending;
+    m_sendStartTime = other.m_sendStartTime;
+    m_enqueueTime = other.m_enqueueTime;
+    m_deadline = other.m_deadline;
+    MoveFrom(std::move(other));
+  }
+  return *this;
+}
+
+SendQueueEntry::~SendQueueEntry() {
+  Reset();
+}
+
+void
+SendQueueEntry::Reset() {
+  switch(m_kind) {
+    case Kind::Unicast:
+      m_unicast.~UnicastQueueEntry();
+      break;
+    case Kind::Broadcast:
+      m_broadcast.~BroadcastQueueEntry();
+      break;
+    case Kind::Empty:
+      break;
+  }
+  m_kind = Kind::Empty;
+}
+
+void
+SendQueueEntry::CopyFrom(const SendQueueEntry& other) {
+  switch(other.m_kind) {
+    case Kind::Unicast:
+      new (&m_unicast) UnicastQueueEntry(other.m_unicast);
+      break;
+    case Kind::Broadcast:
+      new (&m_broadcast) BroadcastQueueEntry(other.m_broadcast);
+      break;
+    case Kind::Empty:
+      break;
+  }
+  m_kind = other.m_kind;
+}
+
+void
+SendQueueEntry::MoveFrom(SendQueueEntry&& other) {
+  switch(other.m_kind) {
+    case Kind::Unicast:
+      new (&m_unicast) UnicastQueueEntry(std::move(other.m_unicast));
+      break;
+    case Kind::Broadcast:
+      new (&m_broadcast) BroadcastQueueEntry(std::move(other.m_broadcast));
+      break;
+    case Kind::Empty:
+      break;
+  }
+  m_kind = other.m_kind;
+  // the moved from entry is left empty
+  other.Reset();
+}
+
+SendQueueEntry::Kind
+SendQueueEntry::GetKind() const {
+  return m_kind;
+}
+
+bool
+SendQueueEntry::IsEmpty() const {
+  return m_kind == Kind::Empty;
+}
+
+bool
+SendQueueEntry::operator()() {
+  switch(m_kind) {
+    case Kind::Unicast:
+      return m_unicast();
+    case Kind::Broadcast:
+      return m_broadcast();
+    case Kind::Empty:
+      break;
+  }
+  return false;
+}
+
+Ptr<const Packet>
+SendQueueEntry::GetPacket() {
+  switch(m_kind) {
+    case Kind::Unicast:
+      return m_unicast.GetPacket();
+    case Kind::Broadcast:
+      return m_broadcast.GetPacket();
+    case Kind::Empty:
+      break;
+  }
+  return Ptr<const Packet>();
+}
+
+Ipv4Address
+SendQueueEntry::NextHop() {
+  switch(m_kind) {
+    case Kind::Unicast:
+      return m_unicast.GetRoute() ? m_unicast.GetRoute()->GetGateway() : Ipv4Address();
+    case Kind::Broadcast:
+      return Ipv4Address::GetBroadcast();
+    case Kind::Empty:
+      break;
+  }
+  return Ipv4Address();
+}
+
+UnicastQueueEntry*
+SendQueueEntry::AsUnicast() {
+  return m_kind == Kind::Unicast ? &m_unicast : nullptr;
+}
+
+BroadcastQueueEntry*
+SendQueueEntry::AsBroadcast() {
+  return m_kind == Kind::Broadcast ? &m_broadcast : nullptr;
+}
 
 bool
 SendQueueEntry::Sending() {
@@ -32,10 +187,30 @@ SendQueueEntry::SendStartTime(Time startTime) {
   m_sendStartTime = startTime;
 }
 
+Time
+SendQueueEntry::EnqueueTime() {
+  return m_enqueueTime;
+}
+
+void
+SendQueueEntry::EnqueueTime(Time enqueueTime) {
+  m_enqueueTime = enqueueTime;
+}
+
+Time
+SendQueueEntry::Deadline() {
+  return m_deadline;
+}
+
+void
+SendQueueEntry::Deadline(Time deadline) {
+  m_deadline = deadline;
+}
+
 // Unicast queue entry ---------------------------------------------------------
 UnicastQueueEntry::UnicastQueueEntry(Ptr<Ipv4Route> route, Ptr<const Packet> packet,
   const Ipv4Header& header, UnicastCallback ufcb)
-   : SendQueueEntry(), m_route(route), m_packet(packet), m_header(header), m_unicastCallback(ufcb) { }
+   : m_route(route), m_packet(packet), m_header(header), m_unicastCallback(ufcb) { }
 
 
 bool
@@ -67,7 +242,7 @@ UnicastQueueEntry::GetRoute() {
 // BroadcastQueueEntry definition ----------------------------------------------
 
 BroadcastQueueEntry::BroadcastQueueEntry(Ptr<Socket> socket, Ptr<Packet> packet, uint32_t flags, InetSocketAddress sockAddr)
-  : SendQueueEntry(), m_broadcastSocket(socket), m_packet(packet), m_flags(flags), m_socketAddress(sockAddr) { }
+  : m_broadcastSocket(socket), m_packet(packet), m_flags(flags), m_socketAddress(sockAddr) { }
 
 bool
 BroadcastQueueEntry::operator()() {
@@ -84,6 +259,18 @@ BroadcastQueueEntry::GetPacket() {
   return m_packet;
 }
 
+void
+BroadcastQueueEntry::SetPacket(Ptr<Packet> packet) {
+  m_packet = packet;
+}
+
+bool
+BroadcastQueueEntry::SameDestination(const BroadcastQueueEntry& other) const {
+  return m_broadcastSocket == other.m_broadcastSocket
+      && m_flags == other.m_flags
+      && m_socketAddress.GetIpv4() == other.m_socketAddress.GetIpv4()
+      && m_socketAddress.GetPort() == other.m_socketAddress.GetPort();
+}
 
 // UnicastAntQueueEntry definition ------------------------------------------------
 // UnicastAntQueueEntry::UnicastAntQueueEntry(Ptr<Socket> socket, Ptr<Packet> packet,
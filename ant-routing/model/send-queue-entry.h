@@ -4,6 +4,8 @@
 #include "ns3/internet-module.h"
 #include <functional>
 #include <memory>
+#include <new>
+#include <vector>
 
 namespace ns3 {
 class Socket;
@@ -14,36 +16,13 @@ class UnicastQueueEntry;
 class BroadcastQueueEntry;
 
 using UnicastCallback = Ipv4RoutingProtocol::UnicastForwardCallback;
-using SendQueueEntries = std::vector<std::shared_ptr<SendQueueEntry>>;
+using SendQueueEntries = std::vector<SendQueueEntry>;
 
-
-struct SendQueueEntry {
-public:
-
-  SendQueueEntry();
-
-  // call operator, each queue entry should be callable (regardless of the type)
-  // call executes the entry in the send queue. Returning a boolean indicating success
-  virtual bool operator()() = 0;
-  virtual Ptr<const Packet> GetPacket() = 0;
-
-  bool Sending();
-  void Sending(bool sending);
-
-  Time SendStartTime();
-  void SendStartTime(Time startTime);
-private:
-  // bookkeeping used for the sender of the queue
-  bool m_sending;
-  Time m_sendStartTime;
-};
-
-// Todo maybe add a timeout for each entry on which to discard it when it is too late?
-struct UnicastQueueEntry : public SendQueueEntry {
+struct UnicastQueueEntry {
 public:
   UnicastQueueEntry( Ptr<Ipv4Route> route, Ptr<const Packet> packet,const Ipv4Header& header,  UnicastCallback ufcb);
-  virtual bool operator()() override;
-  virtual Ptr<const Packet> GetPacket() override;
+  bool operator()();
+  Ptr<const Packet> GetPacket();
 
 
   Ipv4Header GetHeader();
@@ -58,11 +37,15 @@ private:
   UnicastCallback m_unicastCallback;
 };
 
-struct BroadcastQueueEntry : public SendQueueEntry {
+struct BroadcastQueueEntry {
 public:
   BroadcastQueueEntry(Ptr<Socket> socket, Ptr<Packet> packet, uint32_t flags, InetSocketAddress sockAddr);
-  virtual bool operator()() override;
-  virtual Ptr<const Packet> GetPacket() override;
+  bool operator()();
+  Ptr<const Packet> GetPacket();
+  void SetPacket(Ptr<Packet> packet);
+
+  // true if both entries are sent over the same socket to the same address
+  bool SameDestination(const BroadcastQueueEntry& other) const;
 
 private:
   Ptr<Socket> m_broadcastSocket;
@@ -71,9 +54,81 @@ private:
   InetSocketAddress m_socketAddress;
 };
 
+// Entry of a send queue. The entry holds either a unicast or a broadcast
+// entry in place (tagged union), such that the entries are stored inline in
+// the queues and dispatching on the kind of entry is a switch instead of a
+// virtual call. A default constructed entry is empty.
+struct SendQueueEntry {
+public:
+  enum class Kind : uint8_t {
+    Empty = 0,
+    Unicast = 1,
+    Broadcast = 2,
+  };
+
+  SendQueueEntry();
+  SendQueueEntry(UnicastQueueEntry unicast);
+  SendQueueEntry(BroadcastQueueEntry broadcast);
+
+  SendQueueEntry(const SendQueueEntry& other);
+  SendQueueEntry(SendQueueEntry&& other);
+  SendQueueEntry& operator=(const SendQueueEntry& other);
+  SendQueueEntry& operator=(SendQueueEntry&& other);
+  ~SendQueueEntry();
+
+  Kind GetKind() const;
+  bool IsEmpty() const;
+
+  // call operator, each queue entry should be callable (regardless of the type)
+  // call executes the entry in the send queue. Returning a boolean indicating success
+  bool operator()();
+  Ptr<const Packet> GetPacket();
+  // gateway of the route for unicast entries, the broadcast address for
+  // broadcast entries
+  Ipv4Address NextHop();
+
+  // access to the held entry, nullptr if the entry is of another kind
+  UnicastQueueEntry* AsUnicast();
+  BroadcastQueueEntry* AsBroadcast();
+
+  bool Sending();
+  void Sending(bool sending);
+
+  Time SendStartTime();
+  void SendStartTime(Time startTime);
+
+  // time the entry was submitted to the device
+  Time EnqueueTime();
+  void EnqueueTime(Time enqueueTime);
+
+  // time after which the entry is no longer worth sending, the device skips
+  // the entry if it didn't reach the mac by then. Time::Max() if the entry
+  // never expires. The device sets the deadline on submission, unless the
+  // submitter already did.
+  Time Deadline();
+  void Deadline(Time deadline);
+private:
+  // destructs the held entry, leaving an empty entry
+  void Reset();
+  // copies or moves the held entry of other, the entry must be empty
+  void CopyFrom(const SendQueueEntry& other);
+  void MoveFrom(SendQueueEntry&& other);
+
+  Kind m_kind;
+  union {
+    UnicastQueueEntry m_unicast;
+    BroadcastQueueEntry m_broadcast;
+  };
+  // bookkeeping used for the sender of the queue
+  bool m_sending;
+  Time m_sendStartTime;
+  Time m_enqueueTime;
+  Time m_deadline;
+};
+
 template<typename T, typename ...Args>
-std::shared_ptr<SendQueueEntry> MakeSendQueueEntry(Args...args) {
-  return std::make_shared<T>(std::forward<Args>(args)...);
+SendQueueEntry MakeSendQueueEntry(Args&&...args) {
+  return SendQueueEntry(T(std::forward<Args>(args)...));
 }
 
 // // unicasting for ants: doesn't get routed in the same way as regular packets
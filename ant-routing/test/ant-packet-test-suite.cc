@@ -2,6 +2,7 @@
 
 
 #include "ns3/ant-packet.h"
+#include "ns3/packet.h"
 
 // enable ns3 testing
 #include "ns3/test.h"
@@ -42,6 +43,85 @@ MessageDeserializeTestCase1::DoRun(void)
   NS_TEST_ASSERT_MSG_EQ(message, new_message, "The deserialized message should be equal to the message that was serialized.");
 }
 
+class AggregateDeserializeTestCase1 : public TestCase
+{
+public:
+   AggregateDeserializeTestCase1 ();
+   virtual ~AggregateDeserializeTestCase1() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+AggregateDeserializeTestCase1::AggregateDeserializeTestCase1 ()
+  : TestCase("Ant packet test case: splitting an aggregate of ants")
+{
+}
+
+void
+AggregateDeserializeTestCase1::DoRun(void)
+{
+  // two hello ants and a link failure notification in a single packet
+  std::vector<Ptr<const Packet>> ants;
+  for (auto address : { "10.0.0.1", "10.0.0.2" })
+    {
+      auto ant = Create<Packet> ();
+      ant->AddHeader (HelloHeader (Ipv4Address (address)));
+      ant->AddHeader (AntTypeHeader (AntType::HelloAnt));
+      ants.push_back (ant);
+    }
+  auto failure = Create<Packet> ();
+  failure->AddHeader (LinkFailureNotification (Ipv4Address ("10.0.0.3"), { Ipv4Address ("10.0.0.3") }, {}));
+  failure->AddHeader (AntTypeHeader (AntType::LinkFailureAnt));
+  ants.push_back (failure);
+
+  auto aggregate = AggregateHeader::Pack (ants);
+  uint32_t antBytes = 0;
+  for (auto ant : ants)
+    {
+      antBytes += ant->GetSize ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (aggregate->GetSize (), AggregateHeader::GetAggregateSize (3, antBytes), "The size of the aggregate should be known up front");
+
+  AntTypeHeader typeHeader;
+  aggregate->RemoveHeader (typeHeader);
+  NS_TEST_ASSERT_MSG_EQ ((typeHeader.GetAntType () == AntType::AggregateAnt), true, "The packet should be an aggregate");
+
+  std::vector<Ptr<Packet>> received;
+  NS_TEST_ASSERT_MSG_EQ (AggregateHeader::Unpack (aggregate->Copy (), received), true, "The aggregate should be intact");
+  NS_TEST_ASSERT_MSG_EQ (received.size (), 3, "The aggregate should hold three ants");
+  for (std::size_t i = 0; i < received.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (received[i]->GetSize (), ants[i]->GetSize (), "The ants should keep their size");
+      AntTypeHeader expected;
+      ants[i]->PeekHeader (expected);
+      received[i]->RemoveHeader (typeHeader);
+      NS_TEST_ASSERT_MSG_EQ ((typeHeader.GetAntType () == expected.GetAntType ()), true, "The ants should keep their type");
+    }
+  HelloHeader hello;
+  received[1]->RemoveHeader (hello);
+  NS_TEST_ASSERT_MSG_EQ (hello.GetSource (), Ipv4Address ("10.0.0.2"), "The hello ants should keep their source");
+
+  // a truncated aggregate only yields the complete ants
+  auto truncated = aggregate->Copy ();
+  truncated->RemoveAtEnd (1);
+  received.clear ();
+  NS_TEST_ASSERT_MSG_EQ (AggregateHeader::Unpack (truncated, received), false, "The truncation should be detected");
+  NS_TEST_ASSERT_MSG_EQ (received.size (), 2, "The complete ants should be returned");
+
+  // a header cut short yields nothing
+  auto cut = aggregate->CreateFragment (0, 3);
+  received.clear ();
+  NS_TEST_ASSERT_MSG_EQ (AggregateHeader::Unpack (cut, received), false, "The truncated header should be detected");
+  NS_TEST_ASSERT_MSG_EQ (received.size (), 0, "No ants should be returned");
+
+  // aggregates are not nested
+  auto nested = AggregateHeader::Pack ({ ants[0], AggregateHeader::Pack (ants) });
+  nested->RemoveHeader (typeHeader);
+  received.clear ();
+  NS_TEST_ASSERT_MSG_EQ (AggregateHeader::Unpack (nested, received), false, "The nested aggregate should be refused");
+  NS_TEST_ASSERT_MSG_EQ (received.size (), 1, "Only the plain ant should be returned");
+}
+
 class MessageDeserializeTestSuite : public TestSuite
 {
 public:
@@ -52,6 +132,7 @@ MessageDeserializeTestSuite::MessageDeserializeTestSuite ()
   : TestSuite("ant-packet", UNIT)
 {
   AddTestCase (new MessageDeserializeTestCase1, TestCase::QUICK);
+  AddTestCase (new AggregateDeserializeTestCase1, TestCase::QUICK);
 }
 
 static MessageDeserializeTestSuite testSuite;
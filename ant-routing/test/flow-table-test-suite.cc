@@ -0,0 +1,81 @@
+
+// SUT header
+#include "ns3/flow-table.h"
+// enable ns3 testing
+#include "ns3/test.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+namespace ns3 {
+namespace ant_routing {
+
+// Test case 1 -----------------------------------------------------------------
+class FlowTableTestCase1 : public TestCase {
+public:
+  FlowTableTestCase1 ();
+  virtual ~FlowTableTestCase1() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+FlowTableTestCase1::FlowTableTestCase1()
+  : TestCase("Flow table test case: flows are pinned to their first next hop")
+  {}
+
+void FlowTableTestCase1::DoRun(void) {
+  Ipv4Address neighbor1 ("192.168.0.1");
+  Ipv4Address neighbor2 ("192.168.0.2");
+  Ipv4Address destination ("192.168.0.3");
+
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->flowPinning = true;
+  AntRoutingTable rt(config);
+  FlowTable flows(config);
+
+  rt.AddNeighbor(Neighbor(neighbor1, Ptr<NetDevice>()));
+  rt.AddNeighbor(Neighbor(neighbor2, Ptr<NetDevice>()));
+  rt.SetPheromoneAt(neighbor1, destination, PheromoneEntry(1, 1, Seconds(1)));
+  rt.SetPheromoneAt(neighbor2, destination, PheromoneEntry(1, 1, Seconds(1)));
+
+  Ipv4Header header;
+  header.SetSource(Ipv4Address("192.168.0.4"));
+  header.SetDestination(destination);
+  header.SetProtocol(UdpL4Protocol::PROT_NUMBER);
+
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort(49153);
+  udpHeader.SetDestinationPort(9);
+  Ptr<Packet> packet = Create<Packet>(64);
+  packet -> AddHeader(udpHeader);
+
+  auto first = flows.Route(packet, header, rt);
+  NS_TEST_ASSERT_MSG_EQ(first.IsValid(), true, "There should be a route");
+  for(uint32_t i = 0; i < 20; i++) {
+    auto next = flows.Route(packet, header, rt);
+    NS_TEST_ASSERT_MSG_EQ(next.Get().Address(), first.Get().Address(), "The flow should stay on its next hop");
+  }
+  NS_TEST_ASSERT_MSG_EQ(flows.FlowCount(), 1, "There is a single flow");
+
+  // once the pinned hop loses its pheromone the flow moves to the other one
+  auto other = first.Get().Address() == neighbor1 ? neighbor2 : neighbor1;
+  rt.DeletePheromoneEntryFor(first.Get().Address(), destination);
+  auto moved = flows.Route(packet, header, rt);
+  NS_TEST_ASSERT_MSG_EQ(moved.Get().Address(), other, "The flow should be moved to the remaining hop");
+  NS_TEST_ASSERT_MSG_EQ(flows.FlowCount(), 1, "The flow should be pinned again");
+}
+
+// Test suite setup ------------------------------------------------------------
+class FlowTableTestSuite : public TestSuite {
+public:
+  FlowTableTestSuite();
+};
+
+FlowTableTestSuite::FlowTableTestSuite()
+  : TestSuite ("ant-flow-table", UNIT) {
+  //TestCases
+  AddTestCase (new FlowTableTestCase1, TestCase::QUICK);
+}
+
+static FlowTableTestSuite flowTableTestSuite;
+
+} // namespace ant_routing
+} // namespace ns3
@@ -9,10 +9,75 @@
 #include "ns3/wifi-module.h"
 #include "ns3/mobility-module.h"
 #include "ns3/v4ping-helper.h"
+#include <algorithm>
 
 namespace ns3 {
 namespace ant_routing {
 
+// places the nodes on a line and installs wifi and anthocnet on them
+static void
+InstallAdhocNodes(NodeContainer& nodes, std::size_t nodeCount, double distance, AnthocnetConfig config) {
+  nodes.Create(nodeCount);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (distance),
+                                 "DeltaY", DoubleValue (0),
+                                 "GridWidth", UintegerValue (nodeCount),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  WifiMacHelper wifiMac;
+  wifiMac.SetType("ns3::AdhocWifiMac");
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+  wifiPhy.SetChannel (wifiChannel.Create());
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate6Mbps"), "RtsCtsThreshold", UintegerValue (0));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+
+  AnthocnetHelper anthocnet;
+  anthocnet.SetConfig(config);
+  InternetStackHelper stack;
+  stack.SetRoutingHelper(anthocnet);
+  stack.Install(nodes);
+  Ipv4AddressHelper address;
+  address.SetBase("10.0.0.0", "255.0.0.0");
+  address.Assign (devices);
+}
+
+// counts the hellos a node hands to its mac
+class HelloCounter {
+public:
+  HelloCounter(Ptr<AnthocnetRouting> routing);
+  uint32_t CountSince(Time start) const;
+private:
+  void Dequeued(Ptr<const Packet> p, AntNetDevice::Lane lane, Time sojourn);
+  std::vector<Time> m_hellos;
+};
+
+HelloCounter::HelloCounter(Ptr<AnthocnetRouting> routing) {
+  routing->GetDevice().TraceConnectWithoutContext("Dequeue", MakeCallback(&HelloCounter::Dequeued, this));
+}
+
+uint32_t
+HelloCounter::CountSince(Time start) const {
+  return std::count_if(m_hellos.begin(), m_hellos.end(), [start] (Time t) { return t >= start; });
+}
+
+void
+HelloCounter::Dequeued(Ptr<const Packet> p, AntNetDevice::Lane lane, Time sojourn) {
+  // the hellos are broadcast, their packets start with the type of the ant
+  AntTypeHeader typeHeader;
+  if(lane == AntNetDevice::Lane::Expedited && p->PeekHeader(typeHeader) != 0
+     && typeHeader.GetAntType() == AntType::HelloAnt) {
+    m_hellos.push_back(Simulator::Now());
+  }
+}
+
 class HelloRoutingTestCase1 : public TestCase {
 public:
   HelloRoutingTestCase1();
@@ -55,7 +120,10 @@ void HelloRoutingTestCase1::DoRun() {
   NetDeviceContainer devices;
   devices = wifi.Install (wifiPhy, wifiMac, nodes);
 
+  AnthocnetConfig config;
+  config.helloInterval = MilliSeconds(3000);
   AnthocnetHelper anthocnet;
+  anthocnet.SetConfig(config);
   InternetStackHelper stack;
   stack.SetRoutingHelper(anthocnet);
   stack.Install(nodes);
@@ -64,19 +132,86 @@ void HelloRoutingTestCase1::DoRun() {
   Ipv4InterfaceContainer interfaces;
   interfaces = address.Assign (devices);
 
-  AnthocnetRouting::SetHelloTimerInterval(MilliSeconds(3000));
   // SimpleFailureDetector::HelloInterval(MilliSeconds(3000));
 
   Simulator::Stop (Seconds(20));
   Simulator::Run();
 
   Ptr<AnthocnetRouting> routing = nodes.Get(0) -> GetObject<AnthocnetRouting>();
-  auto nbCount = routing->GetRoutingTable().Neighbors().size();
+  auto nbCount = routing->GetRoutingTable().NeighborCount();
   NS_TEST_ASSERT_MSG_EQ(nbCount, 1, "one entry should be added to the routing table");
   Simulator::Destroy();
 }
 
 
+class HelloRoutingTestCase2 : public TestCase {
+public:
+  HelloRoutingTestCase2();
+  virtual ~HelloRoutingTestCase2() = default;
+private:
+  virtual void DoRun() override;
+};
+
+HelloRoutingTestCase2::HelloRoutingTestCase2()
+  : TestCase("Hello routing test case where an idle node doesn't suppress its own hellos") { }
+
+void HelloRoutingTestCase2::DoRun() {
+  AnthocnetConfig config;
+  config.helloInterval = MilliSeconds(3000);
+  config.overhearNeighbors = true;
+  config.helloSuppression = true;
+  NodeContainer nodes;
+  InstallAdhocNodes(nodes, 2, 10, config);
+  HelloCounter hellos(nodes.Get(0) -> GetObject<AnthocnetRouting>());
+
+  Simulator::Stop (Seconds(20));
+  Simulator::Run();
+
+  // the first hello is sent within the first interval
+  NS_TEST_ASSERT_MSG_EQ((hellos.CountSince(Seconds(0)) >= 6), true, "an idle node should send a hello every interval");
+  auto nbCount = nodes.Get(1) -> GetObject<AnthocnetRouting>() -> GetRoutingTable().NeighborCount();
+  NS_TEST_ASSERT_MSG_EQ(nbCount, std::size_t(1), "the idle node should stay a neighbor");
+  Simulator::Destroy();
+}
+
+class HelloRoutingTestCase3 : public TestCase {
+public:
+  HelloRoutingTestCase3();
+  virtual ~HelloRoutingTestCase3() = default;
+private:
+  virtual void DoRun() override;
+};
+
+HelloRoutingTestCase3::HelloRoutingTestCase3()
+  : TestCase("Hello routing test case where busy nodes skip their hellos and are overheard") { }
+
+void HelloRoutingTestCase3::DoRun() {
+  AnthocnetConfig config;
+  config.helloInterval = MilliSeconds(3000);
+  config.overhearNeighbors = true;
+  config.helloSuppression = true;
+  NodeContainer nodes;
+  InstallAdhocNodes(nodes, 3, 10, config);
+  HelloCounter hellos(nodes.Get(0) -> GetObject<AnthocnetRouting>());
+
+  // node 0 and 1 exchange unicast traffic, node 2 only overhears it
+  V4PingHelper ping(Ipv4Address("10.0.0.2"));
+  ping.SetAttribute("Interval", TimeValue(MilliSeconds(100)));
+  ApplicationContainer apps = ping.Install(nodes.Get(0));
+  apps.Start(Seconds(2));
+  apps.Stop(Seconds(20));
+
+  Simulator::Stop (Seconds(20));
+  Simulator::Run();
+
+  // without traffic, five hellos would be sent in this time
+  NS_TEST_ASSERT_MSG_EQ((hellos.CountSince(Seconds(5)) < 3), true, "a busy node should skip its hellos");
+  // the hellos stopped for longer than the failure detection bound
+  auto nbCount = nodes.Get(2) -> GetObject<AnthocnetRouting>() -> GetRoutingTable().NeighborCount();
+  NS_TEST_ASSERT_MSG_EQ(nbCount, std::size_t(2), "the overheard frames should keep the busy nodes as neighbors");
+  Simulator::Destroy();
+}
+
 class HelloMessageTestSuite : public TestSuite {
 public:
   HelloMessageTestSuite();
@@ -85,6 +220,8 @@ public:
 HelloMessageTestSuite::HelloMessageTestSuite()
   : TestSuite("hello-ant", UNIT) {
   AddTestCase(new HelloRoutingTestCase1, TestCase::QUICK);
+  AddTestCase(new HelloRoutingTestCase2, TestCase::QUICK);
+  AddTestCase(new HelloRoutingTestCase3, TestCase::QUICK);
 }
 
 static HelloMessageTestSuite helloMessageTestSuite;
@@ -0,0 +1,106 @@
+
+// SUT header
+#include "ns3/pheromone-kernel.h"
+// enable ns3 testing
+#include "ns3/test.h"
+#include "ns3/core-module.h"
+#include <cmath>
+#include <vector>
+namespace ns3 {
+namespace ant_routing {
+
+// Test case 1 -----------------------------------------------------------------
+class PheromoneKernelTestCase1 : public TestCase {
+public:
+  PheromoneKernelTestCase1 ();
+  virtual ~PheromoneKernelTestCase1() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+PheromoneKernelTestCase1::PheromoneKernelTestCase1()
+  : TestCase("Pheromone kernel test case: fast power against std::pow")
+  {}
+
+void PheromoneKernelTestCase1::DoRun(void) {
+  const std::vector<double> betas { 0.5, 1.0, 1.5, 2.0, 2.5, 3.0, 7.3 };
+  std::vector<double> values;
+  for(double exponent = -20; exponent <= 2; exponent += 0.0137) {
+    values.push_back(std::pow(10.0, exponent));
+  }
+
+  std::vector<double> scalar(values.size());
+  std::vector<double> simd(values.size());
+  for(auto beta : betas) {
+    kernel::ForceScalar(true);
+    kernel::Power(values.data(), scalar.data(), values.size(), beta);
+    kernel::ForceScalar(false);
+    kernel::Power(values.data(), simd.data(), values.size(), beta);
+
+    for(std::size_t i = 0; i < values.size(); i++) {
+      double expected = std::pow(values[i], beta);
+      NS_TEST_ASSERT_MSG_EQ_TOL(scalar[i] / expected, 1.0, 1e-8, "The scalar power should match std::pow");
+      NS_TEST_ASSERT_MSG_EQ_TOL(simd[i] / expected, 1.0, 1e-8, "The vectorized power should match std::pow");
+    }
+  }
+
+  NS_TEST_ASSERT_MSG_EQ(kernel::FastPow(0, 2), 0, "Empty entries have no weight");
+  NS_TEST_ASSERT_MSG_EQ_TOL(kernel::FastPow(0.3, 0), 1.0, 1e-12, "Beta 0 gives equal weights");
+}
+
+// Test case 2 -----------------------------------------------------------------
+class PheromoneKernelTestCase2 : public TestCase {
+public:
+  PheromoneKernelTestCase2 ();
+  virtual ~PheromoneKernelTestCase2() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+PheromoneKernelTestCase2::PheromoneKernelTestCase2()
+  : TestCase("Pheromone kernel test case: cumulative distribution and selection")
+  {}
+
+void PheromoneKernelTestCase2::DoRun(void) {
+  // odd size, such that both the vectorized loop and the tail are used
+  std::vector<double> values;
+  for(uint32_t i = 0; i < 11; i++) {
+    values.push_back(0.1 * (i + 1));
+  }
+
+  for(auto scalar : { true, false }) {
+    kernel::ForceScalar(scalar);
+    std::vector<double> cumulative(values.size());
+    double total = kernel::InclusiveScan(values.data(), cumulative.data(), values.size());
+
+    double expected = 0;
+    for(std::size_t i = 0; i < values.size(); i++) {
+      expected += values[i];
+      NS_TEST_ASSERT_MSG_EQ_TOL(cumulative[i], expected, 1e-12, "The scan should accumulate the values");
+    }
+    NS_TEST_ASSERT_MSG_EQ_TOL(total, expected, 1e-12, "The scan should return the total");
+
+    NS_TEST_ASSERT_MSG_EQ(kernel::SelectIndex(cumulative.data(), cumulative.size(), 0), 0, "The first entry covers the start");
+    NS_TEST_ASSERT_MSG_EQ(kernel::SelectIndex(cumulative.data(), cumulative.size(), 0.25), 1, "The second entry covers (0.1, 0.3]");
+    NS_TEST_ASSERT_MSG_EQ(kernel::SelectIndex(cumulative.data(), cumulative.size(), total * 2), 10, "Points beyond the total select the last entry");
+  }
+  kernel::ForceScalar(false);
+}
+
+// Test suite setup ------------------------------------------------------------
+class PheromoneKernelTestSuite : public TestSuite {
+public:
+  PheromoneKernelTestSuite();
+};
+
+PheromoneKernelTestSuite::PheromoneKernelTestSuite()
+  : TestSuite ("ant-pheromone-kernel", UNIT) {
+  //TestCases
+  AddTestCase (new PheromoneKernelTestCase1, TestCase::QUICK);
+  AddTestCase (new PheromoneKernelTestCase2, TestCase::QUICK);
+}
+
+static PheromoneKernelTestSuite pheromoneKernelTestSuite;
+
+} // namespace ant_routing
+} // namespace ns3
@@ -5,6 +5,8 @@
 #include "ns3/test.h"
 #include "ns3/core-module.h"
 #include <iostream>
+#include <sstream>
+#include <cmath>
 namespace ns3 {
 namespace ant_routing {
 
@@ -81,12 +83,505 @@ void AntRoutingTableTestCase2::DoRun() {
   NS_TEST_ASSERT_MSG_EQ(pheromonePtr->TimeEstimate(), estimate, "The time estimate should be updated");
 
   auto oldPheromoneValue = pheromonePtr -> Value();
-  // test if the pheromone value is updated in place by checking against the pointer.
+  // the routing table hands out copies, fetch the entry again after the update.
   rt.UpdatePheromoneEntry(neighborAddr, destinationAddr, estimate, hops);
+  pheromonePtr = rt.GetPheromone(neighborAddr, destinationAddr);
   expectedPheromone = oldPheromoneValue * AntRoutingTable::Gamma() + (1 - AntRoutingTable::Gamma())*2/(estimate.GetSeconds() + hops*AntRoutingTable::HopTime().GetSeconds());
   NS_TEST_ASSERT_MSG_EQ_TOL(pheromonePtr -> Value(), expectedPheromone, 10E-5, "The pheromone value should be updated");
 }
 
+// TestCase 3 ------------------------------------------------------------------
+class AntRoutingTableTestCase3 : public TestCase {
+public:
+  AntRoutingTableTestCase3 ();
+  virtual ~AntRoutingTableTestCase3() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+AntRoutingTableTestCase3::AntRoutingTableTestCase3()
+  : TestCase("Routing table test case: next hop selection follows pheromone changes")
+  {}
+
+void AntRoutingTableTestCase3::DoRun() {
+  Ipv4Address first ("192.168.0.1");
+  Ipv4Address second ("192.168.0.2");
+  Ipv4Address destination ("192.168.0.3");
+  AntHeader ah;
+  ah.SetSource(Ipv4Address("192.168.0.4"));
+  ah.SetDestination(destination);
+
+  AntRoutingTable rt;
+  rt.AddNeighbor(Neighbor(first, Ptr<NetDevice>()));
+  rt.AddNeighbor(Neighbor(second, Ptr<NetDevice>()));
+
+  // only the first neighbor has a usable entry
+  rt.SetPheromoneAt(first, destination, PheromoneEntry(1, 1, Seconds(1)));
+  for(uint32_t i = 0; i < 10; i++) {
+    auto nb = rt.RouteAnt(ah);
+    NS_TEST_ASSERT_MSG_EQ(nb.IsValid(), true, "There should be a route");
+    NS_TEST_ASSERT_MSG_EQ(nb.Get().Address(), first, "The first neighbor is the only option");
+  }
+
+  // the cached distribution must follow the updates of the table
+  rt.DeletePheromoneEntryFor(first, destination);
+  rt.SetPheromoneAt(second, destination, PheromoneEntry(1, 1, Seconds(1)));
+  for(uint32_t i = 0; i < 10; i++) {
+    auto nb = rt.RouteAnt(ah);
+    NS_TEST_ASSERT_MSG_EQ(nb.IsValid(), true, "There should be a route");
+    NS_TEST_ASSERT_MSG_EQ(nb.Get().Address(), second, "The second neighbor is the only option");
+  }
+
+  // removing the neighbor removes the route
+  rt.RemoveNeighbor(Neighbor(second, Ptr<NetDevice>()));
+  NS_TEST_ASSERT_MSG_EQ(rt.RouteAnt(ah).IsValid(), false, "There should be no route left");
+}
+
+// TestCase 4 ------------------------------------------------------------------
+class AntRoutingTableTestCase4 : public TestCase {
+public:
+  AntRoutingTableTestCase4 ();
+  virtual ~AntRoutingTableTestCase4() = default;
+private:
+  virtual void DoRun(void) override;
+  void CheckEntry(bool present);
+
+  AntRoutingTable m_rt;
+  Ipv4Address m_neighbor;
+  Ipv4Address m_destination;
+};
+
+AntRoutingTableTestCase4::AntRoutingTableTestCase4()
+  : TestCase("Routing table test case: pheromone evaporation"),
+    m_neighbor("192.168.0.1"), m_destination("192.168.0.2")
+  {}
+
+void AntRoutingTableTestCase4::CheckEntry(bool present) {
+  NS_TEST_ASSERT_MSG_EQ(m_rt.HasPheromoneEntryFor(m_destination), present, "Unexpected pheromone entry state");
+  if(present) {
+    auto expected = exp(-Simulator::Now().GetSeconds());
+    NS_TEST_ASSERT_MSG_EQ_TOL(m_rt.GetPheromone(m_neighbor, m_destination)->Value(), expected, 10E-5, "The pheromone should have decayed");
+  }
+}
+
+void AntRoutingTableTestCase4::DoRun() {
+  auto rate = AntRoutingTable::EvaporationRate();
+  auto threshold = AntRoutingTable::EvaporationThreshold();
+  AntRoutingTable::EvaporationRate(1.0);
+  AntRoutingTable::EvaporationThreshold(0.5);
+
+  // the entry drops below the threshold after ln(2) seconds
+  m_rt.AddNeighbor(Neighbor(m_neighbor, Ptr<NetDevice>()));
+  m_rt.SetPheromoneAt(m_neighbor, m_destination, PheromoneEntry(1, 1, Seconds(1)));
+  Simulator::Schedule(Seconds(0.5), &AntRoutingTableTestCase4::CheckEntry, this, true);
+  Simulator::Schedule(Seconds(1), &AntRoutingTableTestCase4::CheckEntry, this, false);
+  Simulator::Run();
+  Simulator::Destroy();
+
+  AntRoutingTable::EvaporationRate(rate);
+  AntRoutingTable::EvaporationThreshold(threshold);
+}
+
+// TestCase 5 ------------------------------------------------------------------
+class AntRoutingTableTestCase5 : public TestCase {
+public:
+  AntRoutingTableTestCase5 ();
+  virtual ~AntRoutingTableTestCase5() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+AntRoutingTableTestCase5::AntRoutingTableTestCase5()
+  : TestCase("Routing table test case: least recently used destinations are evicted")
+  {}
+
+void AntRoutingTableTestCase5::DoRun() {
+  auto maxDestinations = AntRoutingTable::MaxDestinations();
+  AntRoutingTable::MaxDestinations(2);
+
+  Ipv4Address neighbor ("192.168.0.1");
+  Ipv4Address first ("192.168.0.2");
+  Ipv4Address second ("192.168.0.3");
+  Ipv4Address third ("192.168.0.4");
+  AntHeader ah;
+  ah.SetSource(Ipv4Address("192.168.0.5"));
+
+  AntRoutingTable rt;
+  rt.AddNeighbor(Neighbor(neighbor, Ptr<NetDevice>()));
+  rt.SetPheromoneAt(neighbor, first, PheromoneEntry(1, 1, Seconds(1)));
+  rt.SetPheromoneAt(neighbor, second, PheromoneEntry(1, 1, Seconds(1)));
+
+  // looking up the first destination makes the second one the least recently used
+  ah.SetDestination(first);
+  NS_TEST_ASSERT_MSG_EQ(rt.RouteAnt(ah).IsValid(), true, "There should be a route");
+  rt.SetPheromoneAt(neighbor, third, PheromoneEntry(1, 1, Seconds(1)));
+
+  NS_TEST_ASSERT_MSG_EQ(rt.DestinationCount(), 2, "The table should be capped");
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(first), true, "The first destination was used recently");
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(second), false, "The second destination should be evicted");
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(third), true, "The third destination was just added");
+
+  ah.SetDestination(second);
+  NS_TEST_ASSERT_MSG_EQ(rt.RouteAnt(ah).IsValid(), false, "There should be no route");
+  NS_TEST_ASSERT_MSG_EQ(rt.LookupHits(), 1, "One lookup found entries");
+  NS_TEST_ASSERT_MSG_EQ(rt.LookupMisses(), 1, "One lookup found no entries");
+  NS_TEST_ASSERT_MSG_EQ(rt.Evictions(), 1, "One destination was evicted");
+
+  AntRoutingTable::MaxDestinations(maxDestinations);
+}
+
+// Test case 6 -----------------------------------------------------------------
+class AntRoutingTableTestCase6 : public TestCase {
+public:
+  AntRoutingTableTestCase6 ();
+  virtual ~AntRoutingTableTestCase6() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+AntRoutingTableTestCase6::AntRoutingTableTestCase6()
+  : TestCase("Routing table test case: saving and loading snapshots")
+  {}
+
+void AntRoutingTableTestCase6::DoRun() {
+  Ipv4Address neighbor1 ("192.168.0.1");
+  Ipv4Address neighbor2 ("192.168.0.2");
+  Ipv4Address destination1 ("192.168.0.3");
+  Ipv4Address destination2 ("192.168.0.4");
+
+  AntRoutingTable rt;
+  rt.AddNeighbor(Neighbor(neighbor1, Ptr<NetDevice>()));
+  rt.AddNeighbor(Neighbor(neighbor2, Ptr<NetDevice>()));
+  rt.SetPheromoneAt(neighbor1, destination1, PheromoneEntry(0.5, 2, MilliSeconds(4)));
+  rt.SetPheromoneAt(neighbor2, destination1, PheromoneEntry(0.25, 3, MilliSeconds(7)));
+  rt.SetPheromoneAt(neighbor2, destination2, PheromoneEntry(0.125, 1, MilliSeconds(1)));
+
+  std::stringstream snapshot;
+  rt.SaveSnapshot(snapshot);
+  auto bytes = snapshot.str();
+
+  // the same entries stored in another order give the same snapshot
+  AntRoutingTable reordered;
+  reordered.AddNeighbor(Neighbor(neighbor1, Ptr<NetDevice>()));
+  reordered.AddNeighbor(Neighbor(neighbor2, Ptr<NetDevice>()));
+  reordered.SetPheromoneAt(neighbor2, destination1, PheromoneEntry(0.25, 3, MilliSeconds(7)));
+  reordered.SetPheromoneAt(neighbor1, destination1, PheromoneEntry(0.5, 2, MilliSeconds(4)));
+  reordered.SetPheromoneAt(neighbor2, destination2, PheromoneEntry(0.125, 1, MilliSeconds(1)));
+  std::stringstream reorderedSnapshot;
+  reordered.SaveSnapshot(reorderedSnapshot);
+  NS_TEST_ASSERT_MSG_EQ(reorderedSnapshot.str(), bytes, "The snapshots should be identical");
+
+  uint32_t created = 0;
+  AntRoutingTable restored;
+  auto loaded = restored.LoadSnapshot(snapshot, [&created] (Ipv4Address addr) {
+    created++;
+    return Neighbor(addr, Ptr<NetDevice>());
+  });
+
+  NS_TEST_ASSERT_MSG_EQ(loaded, true, "The snapshot should load");
+  NS_TEST_ASSERT_MSG_EQ(created, 2, "Both neighbors should be created");
+  NS_TEST_ASSERT_MSG_EQ(restored.DestinationCount(), 2, "Both destinations should be restored");
+  NS_TEST_ASSERT_MSG_EQ(restored.HasPheromoneEntryFor(neighbor1, destination2), false, "The entry was not in the snapshot");
+
+  auto entry = restored.GetPheromone(neighbor2, destination1);
+  NS_TEST_ASSERT_MSG_EQ((entry != nullptr), true, "The entry should be restored");
+  NS_TEST_ASSERT_MSG_EQ(entry -> Value(), 0.25, "The value should be restored");
+  NS_TEST_ASSERT_MSG_EQ(entry -> HopCount(), 3, "The hop count should be restored");
+  NS_TEST_ASSERT_MSG_EQ(entry -> TimeEstimate(), MilliSeconds(7), "The time estimate should be restored");
+  NS_TEST_ASSERT_MSG_EQ(restored.IsBestEntryFor(neighbor1, destination1), true, "The ranking should be restored");
+
+  std::stringstream restoredSnapshot;
+  restored.SaveSnapshot(restoredSnapshot);
+  NS_TEST_ASSERT_MSG_EQ(restoredSnapshot.str(), bytes, "A restored table should give the same snapshot");
+
+  std::stringstream garbage("not a snapshot");
+  NS_TEST_ASSERT_MSG_EQ(AntRoutingTable().LoadSnapshot(garbage, [] (Ipv4Address addr) {
+    return Neighbor(addr, Ptr<NetDevice>());
+  }), false, "Invalid snapshots should be rejected");
+}
+
+// Test case 7 -----------------------------------------------------------------
+class AntRoutingTableTestCase7 : public TestCase {
+public:
+  AntRoutingTableTestCase7 ();
+  virtual ~AntRoutingTableTestCase7() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+AntRoutingTableTestCase7::AntRoutingTableTestCase7()
+  : TestCase("Routing table test case: iterating the neighbors without copies")
+  {}
+
+void AntRoutingTableTestCase7::DoRun() {
+  Ipv4Address neighbor1 ("192.168.0.1");
+  Ipv4Address neighbor2 ("192.168.0.2");
+  Ipv4Address destination ("192.168.0.3");
+
+  AntRoutingTable rt;
+  NS_TEST_ASSERT_MSG_EQ(rt.NeighborsView().empty(), true, "There are no neighbors yet");
+
+  rt.AddNeighbor(Neighbor(neighbor1, Ptr<NetDevice>()));
+  rt.AddNeighbor(Neighbor(neighbor2, Ptr<NetDevice>()));
+  rt.SetPheromoneAt(neighbor1, destination, PheromoneEntry(1, 1, Seconds(1)));
+
+  auto view = rt.NeighborsView();
+  NS_TEST_ASSERT_MSG_EQ(view.size(), 2, "Both neighbors should be in the view");
+  NS_TEST_ASSERT_MSG_EQ(rt.NeighborCount(), 2, "Both neighbors should be counted");
+  NS_TEST_ASSERT_MSG_EQ(view[0].Address(), neighbor1, "The view keeps the order of insertion");
+
+  uint32_t visited = 0;
+  rt.ForEachNeighbor([&visited] (const Neighbor&) { visited++; });
+  NS_TEST_ASSERT_MSG_EQ(visited, 2, "Every neighbor should be visited");
+
+  std::vector<Ipv4Address> noPheromone;
+  rt.ForEachNoPheromoneNeighbor(destination, [&noPheromone] (const Neighbor& nb) {
+    noPheromone.push_back(nb.Address());
+  });
+  NS_TEST_ASSERT_MSG_EQ(noPheromone.size(), 1, "Only one neighbor lacks an entry");
+  NS_TEST_ASSERT_MSG_EQ(noPheromone[0], neighbor2, "The second neighbor lacks an entry");
+
+  AntHeader ah;
+  ah.SetSource(Ipv4Address("192.168.0.4"));
+  ah.SetDestination(destination);
+  auto routes = rt.BroadcastRouteTo(ah);
+  NS_TEST_ASSERT_MSG_EQ(routes.size(), 2, "There should be a route per neighbor");
+  NS_TEST_ASSERT_MSG_EQ(routes[1] -> GetGateway(), neighbor2, "The route should go via the neighbor");
+  NS_TEST_ASSERT_MSG_EQ(rt.BroadcastRouteTo(ah)[1], routes[1], "The routes should be reused");
+}
+
+// Test case 8 -----------------------------------------------------------------
+class AntRoutingTableTestCase8 : public TestCase {
+public:
+  AntRoutingTableTestCase8 ();
+  virtual ~AntRoutingTableTestCase8() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+AntRoutingTableTestCase8::AntRoutingTableTestCase8()
+  : TestCase("Routing table test case: weighted round-robin packet selection")
+  {}
+
+void AntRoutingTableTestCase8::DoRun() {
+  Ipv4Address neighbor1 ("192.168.0.1");
+  Ipv4Address neighbor2 ("192.168.0.2");
+  Ipv4Address destination ("192.168.0.3");
+
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->packetBeta = 2;
+  config->packetSelection = PacketSelection::WeightedRoundRobin;
+
+  AntRoutingTable rt(config);
+  rt.AddNeighbor(Neighbor(neighbor1, Ptr<NetDevice>()));
+  rt.AddNeighbor(Neighbor(neighbor2, Ptr<NetDevice>()));
+  // weights 1 and 0.25: four packets over the first neighbor for every
+  // packet over the second one
+  rt.SetPheromoneAt(neighbor1, destination, PheromoneEntry(1, 1, Seconds(1)));
+  rt.SetPheromoneAt(neighbor2, destination, PheromoneEntry(0.5, 1, Seconds(1)));
+
+  Ipv4Header header;
+  header.SetSource(Ipv4Address("192.168.0.4"));
+  header.SetDestination(destination);
+
+  uint32_t second = 0;
+  for(uint32_t i = 0; i < 5; i++) {
+    auto nb = rt.RoutePacket(header);
+    NS_TEST_ASSERT_MSG_EQ(nb.IsValid(), true, "There should be a route");
+    if(nb.Get().Address() == neighbor2) {
+      second++;
+      NS_TEST_ASSERT_MSG_EQ(i, 2, "The second neighbor should be spread in between");
+    }
+  }
+  NS_TEST_ASSERT_MSG_EQ(second, 1, "The packets should be split in proportion");
+}
+
+// Test case 9 -----------------------------------------------------------------
+class AntRoutingTableTestCase9 : public TestCase {
+public:
+  AntRoutingTableTestCase9 ();
+  virtual ~AntRoutingTableTestCase9() = default;
+private:
+  virtual void DoRun(void) override;
+  // number of packets routed over the neighbor out of the given ones
+  uint32_t RoutedOver(AntRoutingTable& rt, Ipv4Address neighbor, uint32_t packets);
+
+  Ipv4Header m_header;
+};
+
+AntRoutingTableTestCase9::AntRoutingTableTestCase9()
+  : TestCase("Routing table test case: powered pheromone follows the updates and the beta")
+  {}
+
+void AntRoutingTableTestCase9::DoRun() {
+  Ipv4Address neighbor1 ("192.168.0.1");
+  Ipv4Address neighbor2 ("192.168.0.2");
+  Ipv4Address destination ("192.168.0.3");
+  m_header.SetSource(Ipv4Address("192.168.0.4"));
+  m_header.SetDestination(destination);
+
+  // the round-robin splits the packets in proportion to value^packetBeta,
+  // 90 packets complete the rounds of all the weights below
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->packetBeta = 2;
+  config->packetSelection = PacketSelection::WeightedRoundRobin;
+
+  AntRoutingTable rt(config);
+  rt.AddNeighbor(Neighbor(neighbor1, Ptr<NetDevice>()));
+  rt.AddNeighbor(Neighbor(neighbor2, Ptr<NetDevice>()));
+  rt.SetPheromoneAt(neighbor1, destination, PheromoneEntry(2, 1, Seconds(1)));
+  rt.SetPheromoneAt(neighbor2, destination, PheromoneEntry(1, 1, Seconds(1)));
+  NS_TEST_ASSERT_MSG_EQ(RoutedOver(rt, neighbor2, 90), 18, "The weights should be 4:1");
+
+  rt.SetPheromoneAt(neighbor1, destination, PheromoneEntry(1, 1, Seconds(1)));
+  NS_TEST_ASSERT_MSG_EQ(RoutedOver(rt, neighbor2, 90), 45, "The weights should follow the update");
+  rt.SetPheromoneAt(neighbor1, destination, PheromoneEntry(2, 1, Seconds(1)));
+  NS_TEST_ASSERT_MSG_EQ(RoutedOver(rt, neighbor2, 90), 18, "The weights should follow the update");
+
+  // change the configuration in place, as AnthocnetRouting::SetConfig does
+  auto changed = *config;
+  changed.packetBeta = 3;
+  *config = changed;
+  NS_TEST_ASSERT_MSG_EQ(RoutedOver(rt, neighbor2, 90), 10, "The weights should follow the beta");
+  rt.SetPheromoneAt(neighbor1, destination, PheromoneEntry(4, 1, Seconds(1)));
+  rt.SetPheromoneAt(neighbor2, destination, PheromoneEntry(2, 1, Seconds(1)));
+  NS_TEST_ASSERT_MSG_EQ(RoutedOver(rt, neighbor2, 90), 10, "The updates should use the new beta");
+}
+
+uint32_t
+AntRoutingTableTestCase9::RoutedOver(AntRoutingTable& rt, Ipv4Address neighbor, uint32_t packets) {
+  uint32_t count = 0;
+  for(uint32_t i = 0; i < packets; i++) {
+    auto nb = rt.RoutePacket(m_header);
+    if(nb.IsValid() && nb.Get().Address() == neighbor) {
+      count++;
+    }
+  }
+  return count;
+}
+
+// Test case 10 ----------------------------------------------------------------
+class AntRoutingTableTestCase10 : public TestCase {
+public:
+  AntRoutingTableTestCase10 ();
+  virtual ~AntRoutingTableTestCase10() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+AntRoutingTableTestCase10::AntRoutingTableTestCase10()
+  : TestCase("Routing table test case: destinations with entries follow inserts and erases")
+  {}
+
+void AntRoutingTableTestCase10::DoRun() {
+  Ipv4Address neighbor1 ("192.168.0.1");
+  Ipv4Address neighbor2 ("192.168.0.2");
+  Ipv4Address destination ("192.168.0.3");
+  Ipv4Address other ("192.168.0.4");
+
+  AntRoutingTable rt;
+  rt.AddNeighbor(Neighbor(neighbor1, Ptr<NetDevice>()));
+  rt.AddNeighbor(Neighbor(neighbor2, Ptr<NetDevice>()));
+  rt.SetPheromoneAt(neighbor1, destination, PheromoneEntry(1, 1, Seconds(1)));
+  rt.SetPheromoneAt(neighbor2, destination, PheromoneEntry(1, 1, Seconds(1)));
+  rt.SetPheromoneAt(neighbor2, other, PheromoneEntry(1, 1, Seconds(1)));
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(destination), true, "The destination has two entries");
+  NS_TEST_ASSERT_MSG_EQ(rt.DestinationCount(), 2, "Both destinations have entries");
+
+  // erasing all but the last entry keeps the row
+  rt.DeletePheromoneEntryFor(neighbor1, destination);
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(destination), true, "The second entry is left");
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(neighbor1, destination), false, "The first entry is erased");
+  rt.DeletePheromoneEntryFor(neighbor1, destination);
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(destination), true, "Erasing twice changes nothing");
+
+  // erasing the last entry releases the row
+  rt.DeletePheromoneEntryFor(neighbor2, destination);
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(destination), false, "The last entry is erased");
+  NS_TEST_ASSERT_MSG_EQ(rt.DestinationCount(), 1, "Only the other destination has entries");
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(other), true, "The other destination is untouched");
+
+  // a released row can be filled again
+  rt.SetPheromoneAt(neighbor1, destination, PheromoneEntry(1, 1, Seconds(1)));
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(destination), true, "The destination has an entry again");
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(neighbor2, destination), false, "Only the new entry is present");
+
+  // removing a neighbor erases its entries, the last one of the other row
+  rt.RemoveNeighbor(Neighbor(neighbor2, Ptr<NetDevice>()));
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(other), false, "The entries of the neighbor are erased");
+  NS_TEST_ASSERT_MSG_EQ(rt.HasPheromoneEntryFor(destination), true, "The entries of the others are kept");
+  NS_TEST_ASSERT_MSG_EQ(rt.DestinationCount(), 1, "Only the destination has entries");
+}
+
+// Test case 11 ----------------------------------------------------------------
+class AntRoutingTableTestCase11 : public TestCase {
+public:
+  AntRoutingTableTestCase11 ();
+  virtual ~AntRoutingTableTestCase11() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+AntRoutingTableTestCase11::AntRoutingTableTestCase11()
+  : TestCase("Routing table test case: the best and runner-up entries follow the table")
+  {}
+
+void AntRoutingTableTestCase11::DoRun() {
+  Ipv4Address nb1 ("192.168.0.1");
+  Ipv4Address nb2 ("192.168.0.2");
+  Ipv4Address nb3 ("192.168.0.3");
+  Ipv4Address nb4 ("192.168.0.4");
+  Ipv4Address destination ("192.168.0.5");
+
+  AntRoutingTable rt;
+  for(auto nb : {nb1, nb2, nb3, nb4}) {
+    rt.AddNeighbor(Neighbor(nb, Ptr<NetDevice>()));
+  }
+  rt.SetPheromoneAt(nb1, destination, PheromoneEntry(4, 1, Seconds(1)));
+  rt.SetPheromoneAt(nb2, destination, PheromoneEntry(3, 1, Seconds(1)));
+  rt.SetPheromoneAt(nb3, destination, PheromoneEntry(2, 1, Seconds(1)));
+  rt.SetPheromoneAt(nb4, destination, PheromoneEntry(1, 1, Seconds(1)));
+  NS_TEST_ASSERT_MSG_EQ(rt.IsBestEntryFor(nb1, destination), true, "One is the best");
+  NS_TEST_ASSERT_MSG_EQ(rt.GetBestAlternativeFor(nb1, destination).m_neighbor.Address(), nb2, "Two is the runner-up");
+  NS_TEST_ASSERT_MSG_EQ(rt.GetBestAlternativeFor(nb3, destination).m_neighbor.Address(), nb1, "The best is the alternative for the others");
+
+  // the best entry drops below the runner-up and the third entry
+  rt.SetPheromoneAt(nb1, destination, PheromoneEntry(1.5, 1, Seconds(1)));
+  NS_TEST_ASSERT_MSG_EQ(rt.IsBestEntryFor(nb2, destination), true, "The runner-up takes over");
+  NS_TEST_ASSERT_MSG_EQ(rt.IsBestEntryFor(nb1, destination), false, "One dropped");
+  NS_TEST_ASSERT_MSG_EQ(rt.GetBestAlternativeFor(nb2, destination).m_neighbor.Address(), nb3, "Three is the new runner-up");
+  NS_TEST_ASSERT_MSG_EQ_TOL(rt.BestPheromoneValue(destination), 3, 10E-5, "The best value follows the ranking");
+
+  // the best entry is erased
+  rt.DeletePheromoneEntryFor(nb2, destination);
+  NS_TEST_ASSERT_MSG_EQ(rt.IsBestEntryFor(nb3, destination), true, "The runner-up takes over");
+  NS_TEST_ASSERT_MSG_EQ(rt.GetBestAlternativeFor(nb3, destination).m_neighbor.Address(), nb1, "One is the new runner-up");
+
+  // the best neighbor is removed, the last neighbor takes its place
+  rt.RemoveNeighbor(Neighbor(nb3, Ptr<NetDevice>()));
+  NS_TEST_ASSERT_MSG_EQ(rt.IsBestEntryFor(nb1, destination), true, "The runner-up takes over");
+  NS_TEST_ASSERT_MSG_EQ(rt.IsBestEntryFor(nb4, destination), false, "Four is the runner-up");
+  NS_TEST_ASSERT_MSG_EQ(rt.GetBestAlternativeFor(nb1, destination).m_neighbor.Address(), nb4, "Four is the new runner-up");
+  NS_TEST_ASSERT_MSG_EQ_TOL(rt.BestPheromoneValue(destination), 1.5, 10E-5, "The best value follows the ranking");
+
+  // tied entries are both best and each other's alternative
+  rt.SetPheromoneAt(nb4, destination, PheromoneEntry(1.5, 1, Seconds(1)));
+  NS_TEST_ASSERT_MSG_EQ(rt.IsBestEntryFor(nb1, destination), true, "One ties for the best");
+  NS_TEST_ASSERT_MSG_EQ(rt.IsBestEntryFor(nb4, destination), true, "Four ties for the best");
+  NS_TEST_ASSERT_MSG_EQ(rt.GetBestAlternativeFor(nb1, destination).m_neighbor.Address(), nb4, "Four is the alternative for one");
+  NS_TEST_ASSERT_MSG_EQ(rt.GetBestAlternativeFor(nb4, destination).m_neighbor.Address(), nb1, "One is the alternative for four");
+
+  // the runner-up rises above the best entry
+  rt.SetPheromoneAt(nb4, destination, PheromoneEntry(5, 1, Seconds(1)));
+  NS_TEST_ASSERT_MSG_EQ(rt.IsBestEntryFor(nb4, destination), true, "Four takes over");
+  NS_TEST_ASSERT_MSG_EQ(rt.IsBestEntryFor(nb1, destination), false, "One is the runner-up");
+  NS_TEST_ASSERT_MSG_EQ(rt.GetBestAlternativeFor(nb4, destination).m_neighbor.Address(), nb1, "One is the alternative for four");
+
+  // without a runner-up there is no alternative
+  rt.DeletePheromoneEntryFor(nb1, destination);
+  NS_TEST_ASSERT_MSG_EQ(rt.GetBestAlternativeFor(nb4, destination).m_valid, false, "There is no alternative left");
+}
+
 // Test suite setup ------------------------------------------------------------
 class AntRoutingTableTestSuite : public TestSuite {
 public:
@@ -97,8 +592,16 @@ AntRoutingTableTestSuite::AntRoutingTableTestSuite()
   : TestSuite ("ant-routing-table", UNIT) {
   //TestCases
   AddTestCase (new AntRoutingTableTestCase1, TestCase::QUICK);
-  AddTestCase (new AntRoutingTableTestCase2, TestCase::QUICK)
-;
+  AddTestCase (new AntRoutingTableTestCase2, TestCase::QUICK);
+  AddTestCase (new AntRoutingTableTestCase3, TestCase::QUICK);
+  AddTestCase (new AntRoutingTableTestCase4, TestCase::QUICK);
+  AddTestCase (new AntRoutingTableTestCase5, TestCase::QUICK);
+  AddTestCase (new AntRoutingTableTestCase6, TestCase::QUICK);
+  AddTestCase (new AntRoutingTableTestCase7, TestCase::QUICK);
+  AddTestCase (new AntRoutingTableTestCase8, TestCase::QUICK);
+  AddTestCase (new AntRoutingTableTestCase9, TestCase::QUICK);
+  AddTestCase (new AntRoutingTableTestCase10, TestCase::QUICK);
+  AddTestCase (new AntRoutingTableTestCase11, TestCase::QUICK);
 
 }
 
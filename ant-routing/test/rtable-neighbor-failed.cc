@@ -48,6 +48,61 @@ void RTableFailureTestCase1::DoRun() {
   NS_TEST_ASSERT_MSG_EQ(alts[0].m_neighbor.Address(), nb3, "Three should still be the best alternative for four");
 }
 
+class RTableFailureTestCase2 : public TestCase {
+public:
+  RTableFailureTestCase2();
+  virtual ~RTableFailureTestCase2() = default;
+private:
+  virtual void DoRun();
+  void Update();
+  void Check();
+
+  AntRoutingTable m_rt;
+  Ipv4Address m_nb1;
+  Ipv4Address m_nb2;
+  Ipv4Address m_dest;
+};
+
+RTableFailureTestCase2::RTableFailureTestCase2 ()
+  : TestCase("routing table test case for the best entry of evaporating entries"),
+    m_nb1("0.0.0.1"), m_nb2("0.0.0.2"), m_dest("0.0.0.5") {
+}
+
+void RTableFailureTestCase2::DoRun() {
+  auto rate = AntRoutingTable::EvaporationRate();
+  auto threshold = AntRoutingTable::EvaporationThreshold();
+  AntRoutingTable::EvaporationRate(1.0);
+  AntRoutingTable::EvaporationThreshold(0.001);
+
+  // the first entry has the larger value, but it evaporated to 4 * e^-2
+  // when the second one is set
+  m_rt.AddNeighbor(Neighbor(m_nb1, Ptr<NetDevice>()));
+  m_rt.AddNeighbor(Neighbor(m_nb2, Ptr<NetDevice>()));
+  m_rt.SetPheromoneAt(m_nb1, m_dest, PheromoneEntry(4, 2, MilliSeconds(70)));
+  Simulator::Schedule(Seconds(2), &RTableFailureTestCase2::Update, this);
+  Simulator::Schedule(Seconds(3), &RTableFailureTestCase2::Check, this);
+  Simulator::Run();
+  Simulator::Destroy();
+
+  AntRoutingTable::EvaporationRate(rate);
+  AntRoutingTable::EvaporationThreshold(threshold);
+}
+
+void RTableFailureTestCase2::Update() {
+  m_rt.SetPheromoneAt(m_nb2, m_dest, PheromoneEntry(2, 4, MilliSeconds(90)));
+}
+
+void RTableFailureTestCase2::Check() {
+  NS_TEST_ASSERT_MSG_EQ(m_rt.IsBestEntryFor(m_nb2, m_dest), true, "second should be best");
+  NS_TEST_ASSERT_MSG_EQ(m_rt.IsBestEntryFor(m_nb1, m_dest), false, "the evaporated first should not");
+
+  auto alts = m_rt.BestAlternativesFor(Neighbor(m_nb1, Ptr<NetDevice>()));
+  NS_TEST_ASSERT_MSG_EQ(alts.size(), 0, "Losing the first neighbor loses no best route");
+  alts = m_rt.BestAlternativesFor(Neighbor(m_nb2, Ptr<NetDevice>()));
+  NS_TEST_ASSERT_MSG_EQ(alts.size(), 1, "Losing the second neighbor loses its best route");
+  NS_TEST_ASSERT_MSG_EQ(alts[0].m_neighbor.Address(), m_nb1, "One is the alternative for two");
+}
+
 class RTableFailureTestSuite : public TestSuite {
 public:
   RTableFailureTestSuite();
@@ -56,6 +111,7 @@ public:
 RTableFailureTestSuite::RTableFailureTestSuite()
   : TestSuite("rtable-failure", UNIT) {
     AddTestCase(new RTableFailureTestCase1, TestCase::QUICK);
+    AddTestCase(new RTableFailureTestCase2, TestCase::QUICK);
   }
 
 static RTableFailureTestSuite rTableFalureTestSuite;
@@ -0,0 +1,884 @@
+
+// SUT header
+#include "ns3/ring-buffer.h"
+#include "ns3/send-queue-entry.h"
+#include "ns3/ant-netdevice.h"
+#include "ns3/ant-packet.h"
+// enable ns3 testing
+#include "ns3/test.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include <algorithm>
+namespace ns3 {
+namespace ant_routing {
+
+// emulates the mac below an AntNetDevice without a wifi device: every entry
+// handed to the mac reaches it right away and is reported on after the
+// airtime, as delivered unless its packet is marked to fail
+class MacEmulator {
+public:
+  MacEmulator(AntNetDevice device, Time airtime);
+  void Fail(Ptr<const Packet> packet);
+  // index of the packet in the packets handed to the mac, -1 if not sent
+  int SendIndex(Ptr<const Packet> packet);
+
+  // the packets handed to the mac, in order
+  std::vector<Ptr<const Packet>> m_packets;
+  std::vector<AntNetDevice::Lane> m_lanes;
+  std::vector<Time> m_times;
+private:
+  void Dequeued(Ptr<const Packet> p, AntNetDevice::Lane lane, Time sojourn);
+  void Report(bool delivered);
+
+  AntNetDevice m_device;
+  Time m_airtime;
+  std::vector<Ptr<const Packet>> m_failing;
+  bool m_reportPending;
+};
+
+MacEmulator::MacEmulator(AntNetDevice device, Time airtime)
+  : m_device(device), m_airtime(airtime), m_reportPending(false) {
+  m_device.TraceConnectWithoutContext("Dequeue", MakeCallback(&MacEmulator::Dequeued, this));
+}
+
+void
+MacEmulator::Fail(Ptr<const Packet> packet) {
+  m_failing.push_back(packet);
+}
+
+int
+MacEmulator::SendIndex(Ptr<const Packet> packet) {
+  auto it = std::find(m_packets.begin(), m_packets.end(), packet);
+  return it == m_packets.end() ? -1 : int(it - m_packets.begin());
+}
+
+void
+MacEmulator::Dequeued(Ptr<const Packet> p, AntNetDevice::Lane lane, Time sojourn) {
+  m_packets.push_back(p);
+  m_lanes.push_back(lane);
+  m_times.push_back(Simulator::Now());
+  m_device.NotifyMacTx(p);
+  // entries merged into an aggregate are dequeued along with their carrier
+  if(m_reportPending) {
+    return;
+  }
+  m_reportPending = true;
+  auto delivered = std::find(m_failing.begin(), m_failing.end(), p) == m_failing.end();
+  Simulator::Schedule(m_airtime, &MacEmulator::Report, this, delivered);
+}
+
+void
+MacEmulator::Report(bool delivered) {
+  m_reportPending = false;
+  if(delivered) {
+    m_device.NotifyTxOk();
+  } else {
+    m_device.NotifyTxError();
+  }
+}
+
+// route over the given next hop
+Ptr<Ipv4Route>
+RouteOver(Ipv4Address nextHop) {
+  auto route = Create<Ipv4Route>();
+  route->SetGateway(nextHop);
+  return route;
+}
+
+void
+IgnoreForward(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header) { }
+
+// broadcast entry of the packet to the given address
+SendQueueEntry
+BroadcastTo(Ptr<Packet> packet, Ipv4Address address) {
+  return MakeSendQueueEntry<BroadcastQueueEntry>(Ptr<Socket>(), packet, 0, InetSocketAddress(address, 1012));
+}
+
+// Test case 1 -----------------------------------------------------------------
+class SendQueueTestCase1 : public TestCase {
+public:
+  SendQueueTestCase1 ();
+  virtual ~SendQueueTestCase1() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+SendQueueTestCase1::SendQueueTestCase1()
+  : TestCase("Send queue test case: ring buffer keeps fifo order when wrapping and growing")
+  {}
+
+void SendQueueTestCase1::DoRun(void) {
+  RingBuffer<uint32_t> queue(4);
+  NS_TEST_ASSERT_MSG_EQ(queue.empty(), true, "A new queue is empty");
+
+  // move the head around the end of the slots a couple of times
+  uint32_t pushed = 0;
+  uint32_t popped = 0;
+  for(uint32_t round = 0; round < 10; round++) {
+    for(uint32_t i = 0; i < 3; i++) {
+      queue.push(pushed++);
+    }
+    for(uint32_t i = 0; i < 3; i++) {
+      NS_TEST_ASSERT_MSG_EQ(queue.front(), popped++, "The queue should be fifo");
+      queue.pop();
+    }
+  }
+  NS_TEST_ASSERT_MSG_EQ(queue.capacity(), 4, "The queue should not grow within its capacity");
+
+  // overfill a wrapped queue
+  for(uint32_t i = 0; i < 9; i++) {
+    queue.push(pushed++);
+  }
+  NS_TEST_ASSERT_MSG_EQ(queue.size(), 9, "All the elements should be kept");
+  NS_TEST_ASSERT_MSG_EQ(queue.capacity() >= 9, true, "The queue should have grown");
+  for(uint32_t i = 0; i < 9; i++) {
+    NS_TEST_ASSERT_MSG_EQ(queue[i], popped + i, "Indexing should count from the front");
+  }
+  while(!queue.empty()) {
+    NS_TEST_ASSERT_MSG_EQ(queue.front(), popped++, "The order should survive growing");
+    queue.pop();
+  }
+}
+
+// Test case 2 -----------------------------------------------------------------
+class SendQueueTestCase2 : public TestCase {
+public:
+  SendQueueTestCase2 ();
+  virtual ~SendQueueTestCase2() = default;
+private:
+  virtual void DoRun(void) override;
+  void CounterCallback(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header);
+  uint32_t m_counter = 0;
+};
+
+SendQueueTestCase2::SendQueueTestCase2()
+  : TestCase("Send queue test case: tagged entries dispatch on their kind")
+  {}
+
+void SendQueueTestCase2::DoRun(void) {
+  UnicastCallback cb = MakeCallback(&SendQueueTestCase2::CounterCallback, this);
+  Ipv4Header header;
+  auto packet = Create<Packet>(10);
+
+  SendQueueEntry empty;
+  NS_TEST_ASSERT_MSG_EQ(empty.IsEmpty(), true, "A default entry is empty");
+  NS_TEST_ASSERT_MSG_EQ(empty(), false, "An empty entry sends nothing");
+
+  auto entry = MakeSendQueueEntry<UnicastQueueEntry>(Ptr<Ipv4Route>(), packet, header, cb);
+  NS_TEST_ASSERT_MSG_EQ((entry.GetKind() == SendQueueEntry::Kind::Unicast), true, "The entry holds a unicast entry");
+  NS_TEST_ASSERT_MSG_EQ((entry.AsBroadcast() == nullptr), true, "The entry is no broadcast entry");
+  NS_TEST_ASSERT_MSG_EQ(entry.GetPacket(), packet, "The packet of the held entry should be returned");
+
+  NS_TEST_ASSERT_MSG_EQ(entry.Deadline(), Time::Max(), "A new entry never expires");
+
+  // the bookkeeping and the held entry survive a trip through the queue
+  entry.Sending(true);
+  entry.Deadline(MilliSeconds(20));
+  RingBuffer<SendQueueEntry> queue(1);
+  queue.push(std::move(entry));
+  NS_TEST_ASSERT_MSG_EQ(entry.IsEmpty(), true, "A moved from entry is empty");
+  NS_TEST_ASSERT_MSG_EQ(queue.front().Sending(), true, "The bookkeeping should be moved along");
+  NS_TEST_ASSERT_MSG_EQ(queue.front().Deadline(), MilliSeconds(20), "The deadline should be moved along");
+  NS_TEST_ASSERT_MSG_EQ(queue.front()(), true, "The unicast callback should be called");
+  NS_TEST_ASSERT_MSG_EQ(m_counter, 1, "The unicast callback should be called once");
+
+  auto copy = queue.front();
+  queue.pop();
+  NS_TEST_ASSERT_MSG_EQ(queue.empty(), true, "The queue should be empty");
+  NS_TEST_ASSERT_MSG_EQ((copy.AsUnicast() != nullptr), true, "The copy holds the unicast entry");
+  NS_TEST_ASSERT_MSG_EQ(copy.Deadline(), MilliSeconds(20), "The deadline should be copied");
+  copy();
+  NS_TEST_ASSERT_MSG_EQ(m_counter, 2, "The copy should call the same callback");
+}
+
+void
+SendQueueTestCase2::CounterCallback(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header) {
+  m_counter++;
+}
+
+// Test case 3 -----------------------------------------------------------------
+class SendQueueTestCase3 : public TestCase {
+public:
+  SendQueueTestCase3 ();
+  virtual ~SendQueueTestCase3() = default;
+private:
+  virtual void DoRun(void) override;
+  void Forward(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header);
+  void Enqueued(Ptr<const Packet> p, AntNetDevice::Lane lane);
+  void Dropped(Ptr<const Packet> p, AntNetDevice::Lane lane, AntNetDevice::DropReason reason);
+  uint32_t m_enqueued = 0;
+  uint32_t m_dropped = 0;
+};
+
+SendQueueTestCase3::SendQueueTestCase3()
+  : TestCase("Send queue test case: device traces and sojourn histogram")
+  {}
+
+void SendQueueTestCase3::DoRun(void) {
+  SojournHistogram histogram(MilliSeconds(1), 10);
+  histogram.Add(MicroSeconds(500));
+  histogram.Add(MicroSeconds(1500));
+  histogram.Add(MilliSeconds(50));
+  NS_TEST_ASSERT_MSG_EQ(histogram.GetBinCount(0), 1, "The first bin holds [0, 1ms)");
+  NS_TEST_ASSERT_MSG_EQ(histogram.GetBinCount(1), 1, "The second bin holds [1ms, 2ms)");
+  NS_TEST_ASSERT_MSG_EQ(histogram.GetBinCount(9), 1, "The last bin also counts the longer times");
+  NS_TEST_ASSERT_MSG_EQ(histogram.GetCount(), 3, "All the times should be counted");
+  NS_TEST_ASSERT_MSG_EQ(histogram.GetMax(), MilliSeconds(50), "The maximum should be kept");
+
+  // without a wifi device the first entry stays in flight (the simulation
+  // doesn't run, so the watchdog doesn't fail it)
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->maxQueueSize = 1;
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  device.TraceConnectWithoutContext("Enqueue", MakeCallback(&SendQueueTestCase3::Enqueued, this));
+  device.TraceConnectWithoutContext("Drop", MakeCallback(&SendQueueTestCase3::Dropped, this));
+  NS_TEST_ASSERT_MSG_EQ(device.TraceConnectWithoutContext("Unknown", MakeCallback(&SendQueueTestCase3::Enqueued, this)),
+                        false, "There is no such trace source");
+
+  UnicastCallback cb = MakeCallback(&SendQueueTestCase3::Forward, this);
+  for(uint32_t i = 0; i < 4; i++) {
+    device.Emplace<UnicastQueueEntry>(Ptr<Ipv4Route>(), Create<Packet>(), Ipv4Header(), cb);
+  }
+  NS_TEST_ASSERT_MSG_EQ(m_enqueued, 2, "The entries should be queued up to the maximum");
+  NS_TEST_ASSERT_MSG_EQ(m_dropped, 2, "The other entries should be dropped");
+  NS_TEST_ASSERT_MSG_EQ(device.GetLaneStatistics(AntNetDevice::Lane::Standard).m_overflowDrops, 2, "The drops should be counted");
+  NS_TEST_ASSERT_MSG_EQ(device.GetSojournHistogram(AntNetDevice::Lane::Standard).GetCount(), 1, "One entry was handed to the mac");
+}
+
+void
+SendQueueTestCase3::Forward(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header) { }
+
+void
+SendQueueTestCase3::Enqueued(Ptr<const Packet> p, AntNetDevice::Lane lane) {
+  m_enqueued++;
+}
+
+void
+SendQueueTestCase3::Dropped(Ptr<const Packet> p, AntNetDevice::Lane lane, AntNetDevice::DropReason reason) {
+  NS_TEST_EXPECT_MSG_EQ((reason == AntNetDevice::DropReason::QueueFull), true, "The lane should be full");
+  m_dropped++;
+}
+
+// Test case 4 -----------------------------------------------------------------
+class SendQueueTestCase4 : public TestCase {
+public:
+  SendQueueTestCase4 ();
+  virtual ~SendQueueTestCase4() = default;
+private:
+  virtual void DoRun(void) override;
+  void Forward(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header);
+  void Dropped(Ptr<const Packet> p, AntNetDevice::Lane lane, AntNetDevice::DropReason reason);
+  uint32_t m_stalled = 0;
+};
+
+SendQueueTestCase4::SendQueueTestCase4()
+  : TestCase("Send queue test case: the watchdog fails entries the mac never reports on")
+  {}
+
+void SendQueueTestCase4::DoRun(void) {
+  // without a wifi device the mac never reports on the entries
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->watchdogEnabled = true;
+  config->watchdogMinimum = Seconds(1);
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  device.TraceConnectWithoutContext("Drop", MakeCallback(&SendQueueTestCase4::Dropped, this));
+
+  UnicastCallback cb = MakeCallback(&SendQueueTestCase4::Forward, this);
+  device.Emplace<UnicastQueueEntry>(Ptr<Ipv4Route>(), Create<Packet>(), Ipv4Header(), cb);
+  device.Emplace<UnicastQueueEntry>(Ptr<Ipv4Route>(), Create<Packet>(), Ipv4Header(), cb);
+
+  Simulator::Stop(MilliSeconds(2500));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  NS_TEST_ASSERT_MSG_EQ(m_stalled, 2, "Both entries should be failed by the watchdog");
+  NS_TEST_ASSERT_MSG_EQ(device.GetLaneStatistics(AntNetDevice::Lane::Standard).m_stalls, 2, "The stalls should be counted");
+  NS_TEST_ASSERT_MSG_EQ(device.QueueSize(), 0, "The device should keep draining its queue");
+}
+
+void
+SendQueueTestCase4::Forward(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header) { }
+
+void
+SendQueueTestCase4::Dropped(Ptr<const Packet> p, AntNetDevice::Lane lane, AntNetDevice::DropReason reason) {
+  NS_TEST_EXPECT_MSG_EQ((reason == AntNetDevice::DropReason::Stalled), true, "The entry should have stalled");
+  m_stalled++;
+}
+
+// Test case 5 -----------------------------------------------------------------
+class SendQueueTestCase5 : public TestCase {
+public:
+  SendQueueTestCase5 ();
+  virtual ~SendQueueTestCase5() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+SendQueueTestCase5::SendQueueTestCase5()
+  : TestCase("Send queue test case: a failed next hop is held while the others drain")
+  {}
+
+void SendQueueTestCase5::DoRun(void) {
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->nextHopHoldTime = MilliSeconds(50);
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  MacEmulator mac(device, MilliSeconds(1));
+  UnicastCallback cb = MakeCallback(&IgnoreForward);
+
+  Ipv4Address a("10.0.0.1");
+  Ipv4Address b("10.0.0.2");
+  auto a1 = Create<Packet>(100);
+  auto a2 = Create<Packet>(100);
+  std::vector<Ptr<Packet>> bs{Create<Packet>(100), Create<Packet>(100), Create<Packet>(100)};
+  mac.Fail(a1);
+
+  device.Emplace<UnicastQueueEntry>(RouteOver(a), a1, Ipv4Header(), cb);
+  device.Emplace<UnicastQueueEntry>(RouteOver(a), a2, Ipv4Header(), cb);
+  for(auto packet : bs) {
+    device.Emplace<UnicastQueueEntry>(RouteOver(b), packet, Ipv4Header(), cb);
+  }
+  NS_TEST_ASSERT_MSG_EQ(device.QueueSize(a), 2, "Each next hop has its own queue");
+  NS_TEST_ASSERT_MSG_EQ(device.QueueSize(b), 3, "Each next hop has its own queue");
+
+  Simulator::Stop(MilliSeconds(100));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  NS_TEST_ASSERT_MSG_EQ(mac.m_packets.size(), 5, "All the entries should be handed to the mac");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(a1), 0, "The first entry is sent right away");
+  for(std::size_t i = 0; i < bs.size(); i++) {
+    NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(bs[i]), int(i + 1), "The other next hop drains while the failed one is held");
+  }
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(a2), 4, "The failed next hop is served last");
+  NS_TEST_ASSERT_MSG_EQ(mac.m_times[4], MilliSeconds(51), "Sending resumes once the hold is over");
+  NS_TEST_ASSERT_MSG_EQ(device.QueueSize(), 0, "The queues should be drained");
+}
+
+// Test case 6 -----------------------------------------------------------------
+class SendQueueTestCase6 : public TestCase {
+public:
+  SendQueueTestCase6 ();
+  virtual ~SendQueueTestCase6() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+SendQueueTestCase6::SendQueueTestCase6()
+  : TestCase("Send queue test case: the lanes share the airtime by their weights")
+  {}
+
+void SendQueueTestCase6::DoRun(void) {
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->expeditedLaneWeight = 2;
+  config->standardLaneWeight = 1;
+  config->laneQuantum = 1000;
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  MacEmulator mac(device, MilliSeconds(1));
+  UnicastCallback cb = MakeCallback(&IgnoreForward);
+
+  // the first entry is sent right away, afterwards both lanes are backlogged
+  for(uint32_t i = 0; i < 6; i++) {
+    device.EmplaceExpedited<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), Create<Packet>(1000), Ipv4Header(), cb);
+  }
+  for(uint32_t i = 0; i < 3; i++) {
+    device.Emplace<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), Create<Packet>(1000), Ipv4Header(), cb);
+  }
+
+  Simulator::Stop(MilliSeconds(100));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  auto e = AntNetDevice::Lane::Expedited;
+  auto s = AntNetDevice::Lane::Standard;
+  std::vector<AntNetDevice::Lane> expected{e, s, e, e, s, e, e, s, e};
+  NS_TEST_ASSERT_MSG_EQ(mac.m_lanes.size(), expected.size(), "All the entries should be handed to the mac");
+  for(std::size_t i = 0; i < expected.size(); i++) {
+    NS_TEST_ASSERT_MSG_EQ((mac.m_lanes[i] == expected[i]), true, "The expedited lane should get two quanta per round");
+  }
+  NS_TEST_ASSERT_MSG_EQ(device.GetLaneStatistics(e).m_bytes, 6000, "The bytes of the lane should be counted");
+  NS_TEST_ASSERT_MSG_EQ(device.GetLaneStatistics(s).m_bytes, 3000, "The bytes of the lane should be counted");
+}
+
+// Test case 7 -----------------------------------------------------------------
+class SendQueueTestCase7 : public TestCase {
+public:
+  SendQueueTestCase7 ();
+  virtual ~SendQueueTestCase7() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+SendQueueTestCase7::SendQueueTestCase7()
+  : TestCase("Send queue test case: a starved lane is served once it waited for the bound")
+  {}
+
+void SendQueueTestCase7::DoRun(void) {
+  // strict priority of the expedited lane, only the bound lets data through
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->expeditedLaneWeight = 1;
+  config->standardLaneWeight = 0;
+  config->laneStarvationBound = MilliSeconds(10);
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  MacEmulator mac(device, MilliSeconds(1));
+  UnicastCallback cb = MakeCallback(&IgnoreForward);
+
+  for(uint32_t i = 0; i < 20; i++) {
+    device.EmplaceExpedited<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), Create<Packet>(100), Ipv4Header(), cb);
+  }
+  auto data = Create<Packet>(100);
+  device.Emplace<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), data, Ipv4Header(), cb);
+
+  Simulator::Stop(MilliSeconds(100));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  auto index = mac.SendIndex(data);
+  NS_TEST_ASSERT_MSG_EQ(index, 11, "The data entry should wait for the bound only");
+  NS_TEST_ASSERT_MSG_EQ(mac.m_times[index], MilliSeconds(11), "The data entry should be sent once it waited longer than the bound");
+  NS_TEST_ASSERT_MSG_EQ(device.GetLaneStatistics(AntNetDevice::Lane::Standard).m_starvationOverrides, 1, "The override should be counted");
+
+  // without the bound the data entry waits for all the ants
+  config->laneStarvationBound = Seconds(0);
+  AntNetDevice strict(Ptr<NetDevice>(), config);
+  MacEmulator strictMac(strict, MilliSeconds(1));
+  for(uint32_t i = 0; i < 20; i++) {
+    strict.EmplaceExpedited<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), Create<Packet>(100), Ipv4Header(), cb);
+  }
+  strict.Emplace<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), data, Ipv4Header(), cb);
+
+  Simulator::Stop(MilliSeconds(100));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  NS_TEST_ASSERT_MSG_EQ(strictMac.SendIndex(data), 20, "The expedited lane has strict priority");
+}
+
+// Test case 8 -----------------------------------------------------------------
+class SendQueueTestCase8 : public TestCase {
+public:
+  SendQueueTestCase8 ();
+  virtual ~SendQueueTestCase8() = default;
+private:
+  virtual void DoRun(void) override;
+  // submits a data packet every period until the end
+  void Arrivals(Time period, Time end);
+  void Dropped(Ptr<const Packet> p, AntNetDevice::Lane lane, AntNetDevice::DropReason reason);
+  AntNetDevice* m_device = nullptr;
+  std::vector<Time> m_drops;
+};
+
+SendQueueTestCase8::SendQueueTestCase8()
+  : TestCase("Send queue test case: codel only drops from a standing queue")
+  {}
+
+void SendQueueTestCase8::DoRun(void) {
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->codelEnabled = true;
+  config->codelTarget = MilliSeconds(5);
+  config->codelInterval = MilliSeconds(100);
+  config->maxQueueSize = 1000;
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  MacEmulator mac(device, MilliSeconds(1));
+  m_device = &device;
+  device.TraceConnectWithoutContext("Drop", MakeCallback(&SendQueueTestCase8::Dropped, this));
+
+  // the device sends a packet per millisecond: light load, twice the
+  // capacity for 200ms and light load again once the queue drained
+  Simulator::Schedule(Seconds(0), &SendQueueTestCase8::Arrivals, this, MilliSeconds(2), MilliSeconds(50));
+  Simulator::Schedule(MilliSeconds(100), &SendQueueTestCase8::Arrivals, this, MicroSeconds(500), MilliSeconds(300));
+  Simulator::Schedule(MilliSeconds(600), &SendQueueTestCase8::Arrivals, this, MilliSeconds(2), MilliSeconds(800));
+  Simulator::Stop(Seconds(1));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  NS_TEST_ASSERT_MSG_EQ(m_drops.empty(), false, "The standing queue should be dropped from");
+  // the sojourn time exceeds the target after about 10ms of overload
+  NS_TEST_ASSERT_MSG_EQ((m_drops.front() >= MilliSeconds(200)), true, "The sojourn time has to stay above the target for an interval");
+  NS_TEST_ASSERT_MSG_EQ((m_drops.back() < MilliSeconds(600)), true, "The dropping state should be left once the queue recovers");
+  NS_TEST_ASSERT_MSG_EQ(device.GetLaneStatistics(AntNetDevice::Lane::Standard).m_aqmDrops, m_drops.size(), "The drops should be counted");
+  NS_TEST_ASSERT_MSG_EQ(device.QueueSize(), 0, "The queue should be drained");
+}
+
+void
+SendQueueTestCase8::Arrivals(Time period, Time end) {
+  m_device->Emplace<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), Create<Packet>(100), Ipv4Header(), MakeCallback(&IgnoreForward));
+  if(Simulator::Now() + period < end) {
+    Simulator::Schedule(period, &SendQueueTestCase8::Arrivals, this, period, end);
+  }
+}
+
+void
+SendQueueTestCase8::Dropped(Ptr<const Packet> p, AntNetDevice::Lane lane, AntNetDevice::DropReason reason) {
+  NS_TEST_EXPECT_MSG_EQ((reason == AntNetDevice::DropReason::Aqm), true, "Only the aqm should drop");
+  m_drops.push_back(Simulator::Now());
+}
+
+// Test case 9 -----------------------------------------------------------------
+class SendQueueTestCase9 : public TestCase {
+public:
+  SendQueueTestCase9 ();
+  virtual ~SendQueueTestCase9() = default;
+private:
+  virtual void DoRun(void) override;
+  void SubmitBroadcast(Ptr<Packet> packet);
+  void Enqueued(Ptr<const Packet> p, AntNetDevice::Lane lane);
+  void Dropped(Ptr<const Packet> p, AntNetDevice::Lane lane, AntNetDevice::DropReason reason);
+  AntNetDevice* m_device = nullptr;
+  uint32_t m_enqueued = 0;
+  uint32_t m_dropped = 0;
+};
+
+SendQueueTestCase9::SendQueueTestCase9()
+  : TestCase("Send queue test case: broadcast ants waiting together share a frame")
+  {}
+
+void SendQueueTestCase9::DoRun(void) {
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->broadcastAggregation = true;
+  config->aggregationWindow = MicroSeconds(200);
+  config->maxAggregateSize = 250;
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  MacEmulator mac(device, MilliSeconds(1));
+  m_device = &device;
+  device.TraceConnectWithoutContext("Enqueue", MakeCallback(&SendQueueTestCase9::Enqueued, this));
+  device.TraceConnectWithoutContext("Drop", MakeCallback(&SendQueueTestCase9::Dropped, this));
+
+  Ipv4Address x("10.0.0.255");
+  Ipv4Address y("10.0.1.255");
+  std::vector<Ptr<Packet>> b;
+  for(uint32_t i = 0; i < 10; i++) {
+    b.push_back(Create<Packet>(100));
+  }
+
+  // the other entries wait for the first one
+  auto blocker = Create<Packet>(100);
+  device.EmplaceExpedited<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), blocker, Ipv4Header(), MakeCallback(&IgnoreForward));
+  // b1 and b2 fill an aggregate, b3 and b4 have another destination
+  device.SubmitExpedited(BroadcastTo(b[1], x));
+  device.SubmitExpedited(BroadcastTo(b[2], x));
+  device.SubmitExpedited(BroadcastTo(b[3], x));
+  device.SubmitExpedited(BroadcastTo(b[4], y));
+  // b6 expires before b5 is sent
+  device.SubmitExpedited(BroadcastTo(b[5], x));
+  auto expiring = BroadcastTo(b[6], x);
+  expiring.Deadline(MicroSeconds(500));
+  device.SubmitExpedited(expiring);
+  // b7 is queued outside the window of b8, b9 within
+  Simulator::Schedule(MicroSeconds(500), &SendQueueTestCase9::SubmitBroadcast, this, b[7]);
+  Simulator::Schedule(MicroSeconds(900), &SendQueueTestCase9::SubmitBroadcast, this, b[8]);
+  Simulator::Schedule(MicroSeconds(950), &SendQueueTestCase9::SubmitBroadcast, this, b[9]);
+
+  Simulator::Stop(MilliSeconds(100));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  NS_TEST_ASSERT_MSG_EQ(mac.m_packets.size(), 9, "The merged entries should be dequeued as well");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(blocker), 0, "The first entry is sent right away");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(b[1]), 1, "The first ant of the run is merged");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(b[2]), -1, "The last ant of the run carries the aggregate");
+  NS_TEST_ASSERT_MSG_EQ(mac.m_packets[2]->GetSize(), AggregateHeader::GetAggregateSize(2, 200), "Two ants fit in the aggregate");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(b[3]), 3, "A third ant exceeds the size of the aggregate");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(b[4]), 4, "Ants to another destination are not merged");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(b[5]), 5, "An expired ant is not merged");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(b[6]), -1, "An expired ant is not sent");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(b[7]), 6, "Ants queued outside the window are not merged");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(b[8]), 7, "Ants queued within the window are merged");
+  NS_TEST_ASSERT_MSG_EQ(mac.m_packets[8]->GetSize(), AggregateHeader::GetAggregateSize(2, 200), "Ants queued within the window are merged");
+
+  auto statistics = device.GetLaneStatistics(AntNetDevice::Lane::Expedited);
+  NS_TEST_ASSERT_MSG_EQ(statistics.m_aggregated, 2, "The merged ants should be counted");
+  NS_TEST_ASSERT_MSG_EQ(statistics.m_expiredDrops, 1, "The expired ant should be counted");
+  NS_TEST_ASSERT_MSG_EQ(m_enqueued, mac.m_packets.size() + m_dropped, "Every entry is either dequeued or dropped");
+}
+
+void
+SendQueueTestCase9::SubmitBroadcast(Ptr<Packet> packet) {
+  m_device->SubmitExpedited(BroadcastTo(packet, Ipv4Address("10.0.0.255")));
+}
+
+void
+SendQueueTestCase9::Enqueued(Ptr<const Packet> p, AntNetDevice::Lane lane) {
+  m_enqueued++;
+}
+
+void
+SendQueueTestCase9::Dropped(Ptr<const Packet> p, AntNetDevice::Lane lane, AntNetDevice::DropReason reason) {
+  m_dropped++;
+}
+
+// Test case 10 ----------------------------------------------------------------
+class SendQueueTestCase10 : public TestCase {
+public:
+  SendQueueTestCase10 ();
+  virtual ~SendQueueTestCase10() = default;
+private:
+  virtual void DoRun(void) override;
+};
+
+SendQueueTestCase10::SendQueueTestCase10()
+  : TestCase("Send queue test case: an aggregate is charged to the deficit of its lane")
+  {}
+
+void SendQueueTestCase10::DoRun(void) {
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->broadcastAggregation = true;
+  config->expeditedLaneWeight = 1;
+  config->standardLaneWeight = 1;
+  config->laneQuantum = 500;
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  MacEmulator mac(device, MilliSeconds(1));
+  UnicastCallback cb = MakeCallback(&IgnoreForward);
+
+  device.EmplaceExpedited<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), Create<Packet>(100), Ipv4Header(), cb);
+  for(uint32_t i = 0; i < 9; i++) {
+    device.SubmitExpedited(BroadcastTo(Create<Packet>(100), Ipv4Address("10.0.0.255")));
+  }
+  std::vector<Ptr<Packet>> data;
+  for(uint32_t i = 0; i < 3; i++) {
+    data.push_back(Create<Packet>(500));
+    device.Emplace<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), data.back(), Ipv4Header(), cb);
+  }
+
+  Simulator::Stop(MilliSeconds(100));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  // the aggregate of 920 bytes needs two quanta of the expedited lane
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(data[0]), 1, "The standard lane gets its quantum");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(data[1]), 2, "The aggregate should wait for a second quantum");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(data[2]), 12, "The aggregate is sent with the second quantum");
+  auto aggregateSize = AggregateHeader::GetAggregateSize(9, 900);
+  NS_TEST_ASSERT_MSG_EQ(mac.m_packets[11]->GetSize(), aggregateSize, "The ants should share a single frame");
+  NS_TEST_ASSERT_MSG_EQ(device.GetLaneStatistics(AntNetDevice::Lane::Expedited).m_bytes, 100 + aggregateSize, "The frames should be counted");
+}
+
+// Test case 11 ----------------------------------------------------------------
+class SendQueueTestCase11 : public TestCase {
+public:
+  SendQueueTestCase11 ();
+  virtual ~SendQueueTestCase11() = default;
+private:
+  virtual void DoRun(void) override;
+  void SubmitData(Ptr<Packet> packet);
+  void Dropped(Ptr<const Packet> p, AntNetDevice::Lane lane, AntNetDevice::DropReason reason);
+  AntNetDevice* m_device = nullptr;
+  std::vector<Ptr<const Packet>> m_expired;
+};
+
+SendQueueTestCase11::SendQueueTestCase11()
+  : TestCase("Send queue test case: expired entries are skipped and make room in a full lane")
+  {}
+
+void SendQueueTestCase11::DoRun(void) {
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->maxQueueSize = 2;
+  config->dataLifetime = MilliSeconds(3);
+  config->antLifetime = MilliSeconds(10);
+  config->backwardAntLifetime = MilliSeconds(30);
+  config->helloLifetime = MilliSeconds(2);
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  MacEmulator mac(device, MilliSeconds(5));
+  m_device = &device;
+  device.TraceConnectWithoutContext("Drop", MakeCallback(&SendQueueTestCase11::Dropped, this));
+  UnicastCallback cb = MakeCallback(&IgnoreForward);
+
+  auto antOf = [] (AntType type) {
+    auto packet = Create<Packet>(100);
+    packet->AddHeader(AntTypeHeader(type));
+    return packet;
+  };
+  Ipv4Address broadcast("10.0.0.255");
+
+  // the other entries wait for the first one
+  device.EmplaceExpedited<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), Create<Packet>(100), Ipv4Header(), cb);
+  auto hello = antOf(AntType::HelloAnt);
+  auto forward = antOf(AntType::ProactiveBroadcastAnt);
+  auto backward = antOf(AntType::BackwardAnt);
+  auto lateForward = antOf(AntType::ProactiveBroadcastAnt);
+  device.SubmitExpedited(BroadcastTo(hello, broadcast));
+  device.SubmitExpedited(BroadcastTo(forward, broadcast));
+  device.SubmitExpedited(BroadcastTo(backward, broadcast));
+  device.SubmitExpedited(BroadcastTo(lateForward, broadcast));
+
+  // the data fills the standard lane and expires before the lane is served
+  std::vector<Ptr<Packet>> data;
+  for(uint32_t i = 0; i < 4; i++) {
+    data.push_back(Create<Packet>(100));
+  }
+  for(uint32_t i = 0; i < 3; i++) {
+    auto nextHop = i == 1 ? Ipv4Address("10.0.0.2") : Ipv4Address("10.0.0.1");
+    device.Emplace<UnicastQueueEntry>(RouteOver(nextHop), data[i], Ipv4Header(), cb);
+  }
+  Simulator::Schedule(MilliSeconds(4), &SendQueueTestCase11::SubmitData, this, data[3]);
+
+  Simulator::Stop(MilliSeconds(100));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(hello), -1, "The hello expires with its own lifetime");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(forward), 1, "The expired hello should be skipped");
+  NS_TEST_ASSERT_MSG_EQ(mac.m_times[1], MilliSeconds(5), "The expired hello should not use airtime");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(backward), 2, "The backward ant outlives the other ants");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(lateForward), -1, "The other ants expire with the ant lifetime");
+  NS_TEST_ASSERT_MSG_EQ(mac.SendIndex(data[3]), 3, "The expired data should make room for fresh data");
+  NS_TEST_ASSERT_MSG_EQ(mac.m_packets.size(), 4, "The expired entries should not be sent");
+  NS_TEST_ASSERT_MSG_EQ(m_expired.size(), 5, "Every expired entry should be dropped");
+  // the full standard lane is reaped when the fresh data arrives
+  for(uint32_t i = 0; i < 3; i++) {
+    auto dropped = std::find(m_expired.begin(), m_expired.begin() + 3, data[i]) != m_expired.begin() + 3;
+    NS_TEST_ASSERT_MSG_EQ(dropped, true, "The full lane should drop its expired entries first");
+  }
+
+  auto expedited = device.GetLaneStatistics(AntNetDevice::Lane::Expedited);
+  auto standard = device.GetLaneStatistics(AntNetDevice::Lane::Standard);
+  NS_TEST_ASSERT_MSG_EQ(expedited.m_expiredDrops, 2, "The expired ants should be counted");
+  NS_TEST_ASSERT_MSG_EQ(standard.m_expiredDrops, 3, "The expired data should be counted");
+  NS_TEST_ASSERT_MSG_EQ(standard.m_overflowDrops, 0, "The fresh data should not overflow the lane");
+}
+
+void
+SendQueueTestCase11::SubmitData(Ptr<Packet> packet) {
+  auto entry = MakeSendQueueEntry<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), packet, Ipv4Header(), MakeCallback(&IgnoreForward));
+  entry.Deadline(Seconds(1));
+  m_device->Submit(std::move(entry));
+}
+
+void
+SendQueueTestCase11::Dropped(Ptr<const Packet> p, AntNetDevice::Lane lane, AntNetDevice::DropReason reason) {
+  NS_TEST_EXPECT_MSG_EQ((reason == AntNetDevice::DropReason::Expired), true, "Only expired entries should be dropped");
+  m_expired.push_back(p);
+}
+
+// Test case 12 ----------------------------------------------------------------
+class SendQueueTestCase12 : public TestCase {
+public:
+  SendQueueTestCase12 ();
+  virtual ~SendQueueTestCase12() = default;
+private:
+  virtual void DoRun(void) override;
+  void Dequeued(Ptr<const Packet> p, AntNetDevice::Lane lane, Time sojourn);
+  std::vector<Time> m_times;
+};
+
+SendQueueTestCase12::SendQueueTestCase12()
+  : TestCase("Send queue test case: a late report on a stalled entry is not taken for the next one")
+  {}
+
+void SendQueueTestCase12::DoRun(void) {
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->watchdogEnabled = true;
+  config->watchdogMinimum = Seconds(1);
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  device.TraceConnectWithoutContext("Dequeue", MakeCallback(&SendQueueTestCase12::Dequeued, this));
+  UnicastCallback cb = MakeCallback(&IgnoreForward);
+
+  std::vector<Ptr<Packet>> packets;
+  for(uint32_t i = 0; i < 3; i++) {
+    packets.push_back(Create<Packet>(100));
+    device.Emplace<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), packets.back(), Ipv4Header(), cb);
+  }
+  // the first entry reaches the mac and stalls at 1s, the mac reports on it
+  // after that and on the second entry later on
+  device.NotifyMacTx(packets[0]);
+  Simulator::Schedule(MilliSeconds(1500), &AntNetDevice::NotifyTxOk, &device);
+  Simulator::Schedule(MilliSeconds(1600), &AntNetDevice::NotifyTxOk, &device);
+
+  Simulator::Stop(MilliSeconds(2500));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  NS_TEST_ASSERT_MSG_EQ(m_times.size(), 3, "All the entries should be handed to the mac");
+  NS_TEST_ASSERT_MSG_EQ(m_times[1], Seconds(1), "The second entry follows the stalled one");
+  NS_TEST_ASSERT_MSG_EQ(m_times[2], MilliSeconds(1600), "The late report should not complete the second entry");
+  auto statistics = device.GetLaneStatistics(AntNetDevice::Lane::Standard);
+  NS_TEST_ASSERT_MSG_EQ(statistics.m_stalls, 1, "Only the first entry should stall");
+}
+
+void
+SendQueueTestCase12::Dequeued(Ptr<const Packet> p, AntNetDevice::Lane lane, Time sojourn) {
+  m_times.push_back(Simulator::Now());
+}
+
+// Test case 13 ----------------------------------------------------------------
+class SendQueueTestCase13 : public TestCase {
+public:
+  SendQueueTestCase13 ();
+  virtual ~SendQueueTestCase13() = default;
+private:
+  virtual void DoRun(void) override;
+  void Dequeued(Ptr<const Packet> p, AntNetDevice::Lane lane, Time sojourn);
+  std::vector<Time> m_times;
+};
+
+SendQueueTestCase13::SendQueueTestCase13()
+  : TestCase("Send queue test case: an entry which never reached the mac is owed no report")
+  {}
+
+void SendQueueTestCase13::DoRun(void) {
+  auto config = std::make_shared<AnthocnetConfig>(*AnthocnetConfig::Defaults());
+  config->watchdogEnabled = true;
+  config->watchdogMinimum = Seconds(1);
+  AntNetDevice device(Ptr<NetDevice>(), config);
+  device.TraceConnectWithoutContext("Dequeue", MakeCallback(&SendQueueTestCase13::Dequeued, this));
+  UnicastCallback cb = MakeCallback(&IgnoreForward);
+
+  std::vector<Ptr<Packet>> packets;
+  for(uint32_t i = 0; i < 4; i++) {
+    packets.push_back(Create<Packet>(100));
+    device.Emplace<UnicastQueueEntry>(RouteOver(Ipv4Address("10.0.0.1")), packets.back(), Ipv4Header(), cb);
+  }
+  // the first entry waits for the address resolution and stalls at 1s, the
+  // second one is reported on right away
+  Simulator::Schedule(MilliSeconds(1050), &AntNetDevice::NotifyMacTx, &device, packets[1]);
+  Simulator::Schedule(MilliSeconds(1100), &AntNetDevice::NotifyTxOk, &device);
+  // the first entry reaches the mac after all, while the third one is in flight
+  Simulator::Schedule(MilliSeconds(1150), &AntNetDevice::NotifyMacTx, &device, packets[2]);
+  Simulator::Schedule(MilliSeconds(1200), &AntNetDevice::NotifyMacTx, &device, packets[0]);
+  Simulator::Schedule(MilliSeconds(1300), &AntNetDevice::NotifyTxOk, &device);
+  Simulator::Schedule(MilliSeconds(1400), &AntNetDevice::NotifyTxOk, &device);
+
+  Simulator::Stop(MilliSeconds(2000));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  NS_TEST_ASSERT_MSG_EQ(m_times.size(), 4, "All the entries should be handed to the mac");
+  NS_TEST_ASSERT_MSG_EQ(m_times[1], Seconds(1), "The second entry follows the stalled one");
+  NS_TEST_ASSERT_MSG_EQ(m_times[2], MilliSeconds(1100), "The report on the second entry should be taken");
+  NS_TEST_ASSERT_MSG_EQ(m_times[3], MilliSeconds(1400), "The report on the first entry should be ignored");
+  auto statistics = device.GetLaneStatistics(AntNetDevice::Lane::Standard);
+  NS_TEST_ASSERT_MSG_EQ(statistics.m_stalls, 1, "Only the first entry should stall");
+}
+
+void
+SendQueueTestCase13::Dequeued(Ptr<const Packet> p, AntNetDevice::Lane lane, Time sojourn) {
+  m_times.push_back(Simulator::Now());
+}
+
+// Test suite setup ------------------------------------------------------------
+class SendQueueTestSuite : public TestSuite {
+public:
+  SendQueueTestSuite();
+};
+
+SendQueueTestSuite::SendQueueTestSuite()
+  : TestSuite ("ant-send-queue", UNIT) {
+  //TestCases
+  AddTestCase (new SendQueueTestCase1, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase2, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase3, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase4, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase5, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase6, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase7, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase8, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase9, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase10, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase11, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase12, TestCase::QUICK);
+  AddTestCase (new SendQueueTestCase13, TestCase::QUICK);
+}
+
+static SendQueueTestSuite sendQueueTestSuite;
+
+} // namespace ant_routing
+} // namespace ns3
@@ -4,8 +4,8 @@ using namespace ns3;
 
 // Rho experiment --------------------------------------------------------------
 
-void RhoSetter(double val) {
-  ant_routing::AntRoutingTable::Rho(val);
+void RhoSetter(double val, ant_routing::AnthocnetConfig& config) {
+  config.rho = val;
 }
 
 void RhoPrinter(double val, ant_experiment::Result result) {
@@ -15,9 +15,9 @@ void RhoPrinter(double val, ant_experiment::Result result) {
 const std::vector<double> rhoVector {0.0, 0.25, 0.50, 0.75, 1.0 };
 
 // Ant activation experiment ---------------------------------------------------
-void AntActivationSetter(std::pair<bool, bool> val) {
-  ant_routing::AntNetDevice::SetRepairEnabled(val.first);
-  ant_routing::AnthocnetRouting::SetProactiveEnabled(val.second);
+void AntActivationSetter(std::pair<bool, bool> val, ant_routing::AnthocnetConfig& config) {
+  config.repairEnabled = val.first;
+  config.proactiveEnabled = val.second;
 }
 
 void AntActivationPrinter(std::pair<bool, bool> val, ant_experiment::Result result) {
@@ -34,8 +34,8 @@ const std::vector<std::pair<bool, bool>> comboVector {
   };
 
 // update on failure -----------------------------------------------------------
-void UpdateOnFailureSetter(bool val) {
-  ant_routing::LinkFailureAnt::PheromoneUpdatesOnFailureEnabled(val);
+void UpdateOnFailureSetter(bool val, ant_routing::AnthocnetConfig& config) {
+  config.pheromoneUpdatesOnFailure = val;
 }
 
 void UpdateOnFailurePrinter(bool val, ant_experiment::Result result) {
@@ -48,8 +48,8 @@ const std::vector<bool> onOffVector { true, false };
 
 
 // PacketBeta experiment -------------------------------------------------------
-void PacketBetaSetter(double val) {
-  ant_routing::AntRoutingTable::PacketBeta(val);
+void PacketBetaSetter(double val, ant_routing::AnthocnetConfig& config) {
+  config.packetBeta = val;
 }
 
 void PacketBetaPrinter(double val, ant_experiment::Result result ) {
@@ -61,8 +61,8 @@ const std::vector<double> betaVector { 0.5, 1.0, 1.5, 2.0, 2.5, 3.0 };
 
 // Ant beta experiment ---------------------------------------------------------
 
-void AntBetaSetter(double val) {
-  ant_routing::AntRoutingTable::AntBeta(val);
+void AntBetaSetter(double val, ant_routing::AnthocnetConfig& config) {
+  config.antBeta = val;
 }
 
 void AntBetaPrinter(double val, ant_experiment::Result result ) {
@@ -72,9 +72,9 @@ void AntBetaPrinter(double val, ant_experiment::Result result ) {
 
 // Acceptance factor -----------------------------------------------------------
 
-void AdmissionFactorSetter(double val) {
-  ant_routing::ReactiveQueen::AdmissionRatio(val);
-  ant_routing::RepairQueen::AdmissionRatio(val);
+void AdmissionFactorSetter(double val, ant_routing::AnthocnetConfig& config) {
+  config.reactiveAdmissionRatio = val;
+  config.repairAdmissionRatio = val;
 }
 
 void AdmissionFactorPrinter(double val, ant_experiment::Result result) {
@@ -84,8 +84,8 @@ void AdmissionFactorPrinter(double val, ant_experiment::Result result) {
 const std::vector<double> admissionVector { 0.5, 1.0, 1.5, 2.0, 2.5 };
 
 // proactive probability -------------------------------------------------------
-void ProbabilitySetter(double val) {
-  ant_routing::AnthocnetRouting::SetProactiveProbability(val);
+void ProbabilitySetter(double val, ant_routing::AnthocnetConfig& config) {
+  config.proactiveProbability = val;
 }
 
 
@@ -105,6 +105,29 @@ RoutingExperiment::WriteTracesEnabled(bool val) {
   s_writeTraces = val;
 }
 
+std::string RoutingExperiment::s_snapshotPrefix = "";
+bool RoutingExperiment::s_warmStart = false;
+
+std::string
+RoutingExperiment::SnapshotPrefix() {
+  return s_snapshotPrefix;
+}
+
+void
+RoutingExperiment::SnapshotPrefix(std::string prefix) {
+  s_snapshotPrefix = prefix;
+}
+
+bool
+RoutingExperiment::WarmStartEnabled() {
+  return s_warmStart;
+}
+
+void
+RoutingExperiment::WarmStartEnabled(bool val) {
+  s_warmStart = val;
+}
+
 
 
 RoutingExperiment::RoutingExperiment (uint32_t protocol, int nSinks, Scenario scenario)
@@ -390,6 +413,22 @@ RoutingExperiment::SetupAddresses ()
   m_adhocInterfaces = address.Assign (m_adhocDevices);
   m_senderInterfaces = address.Assign (m_senderDevices);
   m_receiverInterfaces = address.Assign (m_receiverDevices);
+
+  // the interfaces are up, the routing state can be warm-started
+  if (m_protocol == ANTHOCNET_PROTOCOL && !SnapshotPrefix ().empty ())
+  {
+    if (WarmStartEnabled ())
+    {
+      AnthocnetHelper::LoadSnapshotAll (SnapshotPrefix ());
+      // skip the route discovery phase, keep the traffic duration
+      TotalTime -= TrafficStart - 1.0;
+      TrafficStart = 1.0;
+    }
+    else
+    {
+      AnthocnetHelper::SaveSnapshotAllAt (Seconds (TrafficStart), SnapshotPrefix ());
+    }
+  }
 }
 
 void
@@ -410,7 +449,7 @@ RoutingExperiment::SetupApplications ()
 
     Ptr<UniformRandomVariable> var = CreateObject<UniformRandomVariable> ();
     ApplicationContainer temp = onoff1.Install (m_senderNodes.Get (i));
-    temp.Start (Seconds (var->GetValue (100.0,101.0)));
+    temp.Start (Seconds (var->GetValue (TrafficStart, TrafficStart + 1.0)));
     temp.Stop (Seconds (TotalTime));
   }
 }
@@ -90,6 +90,15 @@ public:
   static bool WriteTracesEnabled();
   static void WriteTracesEnabled(bool val);
 
+  // prefix of the AntHocNet routing snapshots, empty disables snapshots.
+  // Without warm start the snapshots are saved when the traffic starts,
+  // with warm start they are loaded at the beginning of the simulation
+  // and the traffic starts right away.
+  static std::string SnapshotPrefix();
+  static void SnapshotPrefix(std::string prefix);
+  static bool WarmStartEnabled();
+  static void WarmStartEnabled(bool val);
+
 private:
   static constexpr const char* phyMode = "DsssRate11Mbps";
   static constexpr const char* rate = "2048bps";
@@ -118,6 +127,7 @@ private:
   Scenario m_scenario;
 
   double TotalTime = 200.0;
+  double TrafficStart = 100.0;
   std::string m_protocolName;
 
   int nodePause = 20;
@@ -143,6 +153,8 @@ private:
   FlowMonitorHelper m_flowmonHelper;
 
   static bool s_writeTraces;
+  static std::string s_snapshotPrefix;
+  static bool s_warmStart;
 };
 
 std::ostream& operator <<(std::ostream& os, const Result& result);
@@ -107,7 +107,8 @@ ParamExperimentSuite::GetResult () const
   return m_results;
 }
 
-ParamExperiment::ParamExperiment (uint32_t protocol, int nSinks, Scenario scenario)
+ParamExperiment::ParamExperiment (uint32_t protocol, int nSinks, Scenario scenario,
+                                  ant_routing::AnthocnetConfig config)
 : port (3001),
   bytesTotal (0),
   packetsReceived (0),
@@ -115,7 +116,8 @@ ParamExperiment::ParamExperiment (uint32_t protocol, int nSinks, Scenario scenar
   m_protocol (protocol),
   m_txp (2),
   m_nSinks (nSinks),
-  m_scenario (scenario)
+  m_scenario (scenario),
+  m_config (config)
 {
 }
 
@@ -348,6 +350,7 @@ ParamExperiment::SetupProtocol ()
   OlsrHelper olsr;
   DsdvHelper dsdv;
   AnthocnetHelper anthocnet;
+  anthocnet.SetConfig (m_config);
 
   Ipv4ListRoutingHelper list;
   InternetStackHelper internet;
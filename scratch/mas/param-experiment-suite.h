@@ -66,7 +66,8 @@ class ParamExperiment
 {
 public:
   // RoutingExperiment ();
-  ParamExperiment (uint32_t protocol, int nSinks, Scenario scenario);
+  ParamExperiment (uint32_t protocol, int nSinks, Scenario scenario,
+                   ant_routing::AnthocnetConfig config = *ant_routing::AnthocnetConfig::Defaults ());
   void Run ();
   // static void SetMACParam (ns3::NetDeviceContainer & devices,
   //                                 int slotDistance);
@@ -99,6 +100,7 @@ private:
   double m_txp;
   int m_nSinks;
   Scenario m_scenario;
+  ant_routing::AnthocnetConfig m_config;
 
   double TotalTime = 200.0;
   std::string m_protocolName;
@@ -135,7 +137,7 @@ public:
   std::vector<Result> GetResult () const;
 
   template<typename T>
-  void RunSuite(std::vector<T> paramValues, std::function<void(T)> paramSetter ,std::function<void(T, Result)> printer);
+  void RunSuite(std::vector<T> paramValues, std::function<void(T, ant_routing::AnthocnetConfig&)> paramSetter ,std::function<void(T, Result)> printer);
 private:
   uint8_t m_nSimulations;
   std::vector<Result> m_results;
@@ -143,7 +145,7 @@ private:
 };
 template<typename T>
 void ParamExperimentSuite::RunSuite(std::vector<T> paramValues,
-                                    std::function<void(T)> paramSetter,
+                                    std::function<void(T, ant_routing::AnthocnetConfig&)> paramSetter,
                                     std::function<void(T, Result)> printer) {
 
   int nSinks = 5;
@@ -152,10 +154,12 @@ void ParamExperimentSuite::RunSuite(std::vector<T> paramValues,
     for (auto value : paramValues)
     {
       std::vector<Result> expResults;
-      paramSetter(value);
+      // every value gets its own configuration, the defaults are left untouched
+      auto config = *ant_routing::AnthocnetConfig::Defaults();
+      paramSetter(value, config);
       for (int i = 0; i < m_nSimulations; i++)
       {
-        ParamExperiment experiment (4, nSinks, scenario);
+        ParamExperiment experiment (4, nSinks, scenario, config);
         std::cout << "\33[2K" << "Run " << (i + 1) << " of " << (uint32_t)m_nSimulations << "\r" << std::flush;
         RngSeedManager::SetRun(i+1);
         experiment.Run ();